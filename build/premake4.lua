@@ -76,3 +76,37 @@ solution "libembindcefv8"
                 "pthread"
                 }
             libdirs { "../deps/lib" }
+            if os.is("linux") then
+                links { "dl" }
+                -- Plugins resolve the library symbols against the executable.
+                linkoptions { "-rdynamic" }
+            end
+
+    project "testplugin"
+        kind "SharedLib"
+        language "C++"
+
+        files {
+            "../tests/plugin/*.cpp"
+            }
+
+        includedirs {
+            "../src/"
+            }
+
+        targetdir "../tests/"
+
+        if not os.is("windows") then
+            buildoptions { "-std=c++1z -fPIC" }
+        end
+
+        if os.is("linux") then
+            defines { "_LINUX" }
+        end
+
+        configuration "*Cef"
+            defines { "CEF" }
+            includedirs { "../deps/include/cef/" }
+
+        configuration "*Emscripten"
+            defines { "EMSCRIPTEN" }
@@ -1,16 +1,202 @@
 #include "embindcefv8.h"
 
+#ifdef CEF
+    #include "include/cef_task.h"
+    #include <limits>
+    #include <memory>
+    #include <set>
+    #include <typeindex>
+    #include <unordered_map>
+
+    #if defined(__AVX2__)
+        #include <immintrin.h>
+    #endif
+
+    #if defined(__SSE2__) || defined(_M_X64)
+        #define EMBINDCEFV8_SSE2
+        #include <emmintrin.h>
+    #endif
+
+    #ifdef _WIN32
+        #include <windows.h>
+    #else
+        #include <dlfcn.h>
+    #endif
+#endif
+
+#if defined(CEF) && defined(EMBINDCEFV8_SECTION)
+    // Bounds of the descriptor section, provided by the linker; weak so an empty section still links.
+    #ifdef __APPLE__
+        extern const embindcefv8::InitializerEntry embindcefv8SectionStart __asm("section$start$__DATA$embindcefv8");
+        extern const embindcefv8::InitializerEntry embindcefv8SectionStop __asm("section$end$__DATA$embindcefv8");
+        #define EMBINDCEFV8_SECTION_START (&embindcefv8SectionStart)
+        #define EMBINDCEFV8_SECTION_STOP (&embindcefv8SectionStop)
+    #else
+        extern "C" const embindcefv8::InitializerEntry __start_embindcefv8_init[] __attribute__((weak));
+        extern "C" const embindcefv8::InitializerEntry __stop_embindcefv8_init[] __attribute__((weak));
+        #define EMBINDCEFV8_SECTION_START __start_embindcefv8_init
+        #define EMBINDCEFV8_SECTION_STOP __stop_embindcefv8_init
+    #endif
+#endif
+
 namespace embindcefv8
 {
     #ifdef CEF
+        // An object handed out to renderers, with the class it was registered as; removed objects keep a null entry so handles are never reused.
+        struct ProxyEntry
+        {
+            void
+                * object;
+            int
+                classId;
+        };
+
+        struct ProxyGlobal
+        {
+            std::string
+                name;
+            int
+                handle;
+            int
+                classId;
+        };
+
+        struct ProxyData : public CefBase
+        {
+            ProxyData(const int _handle, const int _class_id)
+                :
+                handle(_handle),
+                classId(_class_id)
+            {
+            }
+
+            int
+                handle;
+            int
+                classId;
+
+            IMPLEMENT_REFCOUNTING(ProxyData);
+        };
+
+        struct PendingProxyCall
+        {
+            CefRefPtr<CefV8Context>
+                context;
+            CefRefPtr<CefV8Value>
+                resolve;
+            CefRefPtr<CefV8Value>
+                reject;
+        };
+
+        struct Plugin
+        {
+            Plugin(const std::string & _name, void * _handle)
+                :
+                name(_name),
+                handle(_handle),
+                firstClass(0),
+                lastClass(0),
+                firstBinding(0),
+                lastBinding(0),
+                firstValueObject(0),
+                lastValueObject(0),
+                firstRegisterer(0),
+                lastRegisterer(0),
+                unloaded(false)
+            {
+            }
+
+            std::string
+                name;
+            void
+                * handle;
+            int
+                firstClass,
+                lastClass,
+                firstBinding,
+                lastBinding,
+                firstValueObject,
+                lastValueObject,
+                firstRegisterer,
+                lastRegisterer;
+            bool
+                unloaded;
+            // Contexts alive at unload may still hold wrappers whose accessors live in the library.
+            std::set<ContextRegistry *>
+                holders;
+        };
+
+        struct ProxyBatch
+        {
+            CefRefPtr<CefBrowser>
+                browser;
+            WireWriter
+                writer;
+        };
+
+        static const char
+            * proxyInfoMarker = "embindcefv8",
+            * proxyCallsMessage = "embindcefv8.calls",
+            * proxyRepliesMessage = "embindcefv8.replies",
+            * deferredFactoryCode =
+                "(function() {"
+                "    var d = {};"
+                "    d.promise = new Promise(function(resolve, reject) {"
+                "        d.resolve = resolve;"
+                "        d.reject = function(message) { reject(new Error(message)); };"
+                "    });"
+                "    return d;"
+                "})";
+
+        enum ProxyCallKind
+        {
+            PROXY_CALL_METHOD,
+            PROXY_CALL_STATIC_FUNCTION
+        };
+
         std::vector<Registerer>
             registerers;
         CefRefPtr<CefBrowser>
             browser;
-        CefRefPtr<CefV8Context>
-            context;
-        CefRefPtr<CefV8Value>
-            moduleObject;
+        // Shared so that accessors outliving their context can tell it was released.
+        std::vector<std::shared_ptr<ContextRegistry>>
+            contextRegistries;
+
+        bool
+            bindingsReady = false,
+            extensionRegistered = false,
+            proxyFlushScheduled = false;
+        int
+            extensionClassCount = 0,
+            extensionBindingCount = 0;
+        std::vector<Plugin>
+            plugins;
+        std::string
+            pluginDirectory = ".";
+        // Names pages may pass to Module.load; load and unload are only defined when it is not empty.
+        std::set<std::string>
+            allowedPlugins;
+        bool
+            argumentValidation = true;
+        int
+            integerCacheMinimum = -128,
+            integerCacheMaximum = 1023;
+        std::unordered_map<std::type_index, int>
+            mostDerivedClasses;
+        std::vector<ProxyEntry>
+            proxyObjects;
+        std::map<std::pair<void *, int>, int>
+            proxyHandles;
+        std::vector<ProxyGlobal>
+            proxyGlobals;
+        std::map<int, ProxyBatch>
+            proxyBatches;
+        std::map<uint32, PendingProxyCall>
+            pendingProxyCalls;
+        uint32
+            nextProxyCallId = 0;
+
+        void installProxies(ContextRegistry & registry);
 
         std::map<std::string, Initializer> & getInitializers()
         {
@@ -20,51 +206,2613 @@ namespace embindcefv8
             return initializers;
         }
 
-        void onContextCreated(CefV8Context *context_)
+        // Backs the class entries of Module: a class's constructor function is only built on first read.
+        // Module can outlive its context, e.g. when another frame kept a reference; it is then left inert.
+        class ModuleAccessor : public CefV8Accessor
         {
-            context = context_;
-            moduleObject = CefV8Value::CreateObject(nullptr);
-            context->GetGlobal()->SetValue("Module", moduleObject, V8_PROPERTY_ATTRIBUTE_NONE);
+        public:
+            ModuleAccessor(const std::shared_ptr<ContextRegistry> & _registry)
+                :
+                CefV8Accessor(),
+                registry(_registry)
+            {
+            }
 
-            for(auto& kv : getInitializers())
+            virtual bool Get(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception) override
             {
-                kv.second();
+                std::shared_ptr<ContextRegistry> locked = registry.lock();
+                int id = locked ? findClass(name) : -1;
+
+                if(id < 0 || !getClasses()[id].createConstructor)
+                {
+                    return false;
+                }
+
+                auto & constructor = locked->constructors[id];
+
+                if(!constructor)
+                {
+                    constructor = getClasses()[id].createConstructor(*locked);
+                }
+
+                retval = constructor;
+                return true;
+            }
+
+            virtual bool Set(const CefString& name, const CefRefPtr<CefV8Value> object, const CefRefPtr<CefV8Value> value, CefString& exception) override
+            {
+                std::shared_ptr<ContextRegistry> locked = registry.lock();
+                int id = locked ? findClass(name) : -1;
+
+                if(id < 0)
+                {
+                    return false;
+                }
+
+                locked->constructors[id] = value;
+                return true;
+            }
+
+            IMPLEMENT_REFCOUNTING(ModuleAccessor);
+        private:
+            std::weak_ptr<ContextRegistry>
+                registry;
+        };
+
+        class PluginHandler : public CefV8Handler
+        {
+        public:
+            virtual bool Execute(const CefString& name, CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception) override
+            {
+                std::string error;
+
+                if(arguments.size() != 1 || !arguments[0]->IsString())
+                {
+                    exception = "embindcefv8: expected a plugin name";
+                    return true;
+                }
+
+                const std::string plugin_name = arguments[0]->GetStringValue();
+
+                if(!allowedPlugins.count(plugin_name))
+                {
+                    exception = "embindcefv8: plugin " + plugin_name + " is not allowed";
+                    return true;
+                }
+
+                if(name == "load" ? loadPlugin(plugin_name, error) : unloadPlugin(plugin_name, error))
+                {
+                    retval = CefV8Value::CreateBool(true);
+                }
+                else
+                {
+                    exception = error;
+                }
+
+                return true;
             }
 
-            for(auto func : registerers)
+            IMPLEMENT_REFCOUNTING(PluginHandler);
+        };
+
+        // Binding id lookup for command buffers: own bindings first, then the base classes.
+        static int findBinding(int class_id, const std::string & name)
+        {
+            auto & bindings = getBindings();
+
+            do
             {
-                func(moduleObject);
+                for(int i = int(bindings.size()) - 1; i >= 0; --i)
+                {
+                    if(bindings[i].classId == class_id && bindings[i].name == name && bindings[i].kind != BindingKind::Constructor)
+                    {
+                        return i;
+                    }
+                }
+
+                class_id = class_id >= 0 ? getClasses()[class_id].getBaseId() : -1;
             }
+            while(class_id >= 0);
+
+            return -1;
         }
 
-        void setBrowser(CefRefPtr<CefBrowser> _browser)
+        // Module.__binding(className, name) and Module.__flush([id, target, argc, args..., id, ...]).
+        class CommandBufferHandler : public CefV8Handler
         {
-            browser = _browser;
+        public:
+            virtual bool Execute(const CefString& name, CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception) override
+            {
+                if(name == "__binding")
+                {
+                    if(arguments.size() != 2 || !arguments[1]->IsString())
+                    {
+                        exception = "embindcefv8: expected a class name and a binding name";
+                        return true;
+                    }
+
+                    int class_id = arguments[0]->IsString() ? findClass(arguments[0]->GetStringValue()) : -1;
+
+                    retval = CefV8Value::CreateInt(findBinding(class_id, arguments[1]->GetStringValue()));
+                    return true;
+                }
+
+                if(arguments.size() != 1 || !arguments[0]->IsArray())
+                {
+                    exception = "embindcefv8: expected a command buffer";
+                    return true;
+                }
+
+                auto & buffer = arguments[0];
+                int length = buffer->GetArrayLength();
+                int position = 0;
+                CefV8ValueList call_arguments;
+                std::vector<CefRefPtr<CefV8Value>> results;
+
+                while(position + 3 <= length)
+                {
+                    int id = buffer->GetValue(position)->GetIntValue();
+                    CefRefPtr<CefV8Value> target = buffer->GetValue(position + 1);
+                    int count = buffer->GetValue(position + 2)->GetIntValue();
+                    CefRefPtr<CefV8Value> result;
+
+                    position += 3;
+
+                    if(count < 0 || position + count > length)
+                    {
+                        exception = "embindcefv8: truncated command buffer";
+                        return true;
+                    }
+
+                    call_arguments.clear();
+
+                    for(int i = 0; i < count; ++i)
+                    {
+                        call_arguments.push_back(buffer->GetValue(position + i));
+                    }
+
+                    position += count;
+                    if(!invokeBinding(id, target, call_arguments, result, exception))
+                    {
+                        return true;
+                    }
+
+                    results.push_back(result ? result : createUndefined());
+                }
+
+                retval = CefV8Value::CreateArray(int(results.size()));
+
+                for(size_t i = 0; i < results.size(); ++i)
+                {
+                    retval->SetValue(int(i), results[i]);
+                }
+
+                return true;
+            }
+
+            IMPLEMENT_REFCOUNTING(CommandBufferHandler);
+        };
+
+        static void growRegistry(ContextRegistry & registry)
+        {
+            size_t count = getClasses().size();
+
+            registry.constructors.resize(count);
+            registry.methods.resize(count);
+            registry.methodsReady.resize(count, false);
         }
 
-        bool hasContext()
+        static void installClass(ContextRegistry & registry, const int id)
         {
-            return context;
+            auto & info = getClasses()[id];
+
+            if(!info.createConstructor || isExtensionClass(id))
+            {
+                return;
+            }
+
+            if(extensionRegistered)
+            {
+                registry.constructors[id] = info.createConstructor(registry);
+                registry.moduleObject->SetValue(info.name, registry.constructors[id], V8_PROPERTY_ATTRIBUTE_NONE);
+            }
+            else
+            {
+                registry.moduleObject->SetValue(info.name, V8_ACCESS_CONTROL_DEFAULT, V8_PROPERTY_ATTRIBUTE_NONE);
+            }
         }
 
-        CefRefPtr<CefV8Value> & getModuleObject()
+        void onContextCreated(CefV8Context *context)
         {
-            return moduleObject;
+            ensureBindings();
+
+            contextRegistries.push_back(std::make_shared<ContextRegistry>());
+
+            auto & registry = *contextRegistries.back();
+            CefRefPtr<CefV8Handler> plugin_handler = new PluginHandler();
+            CefRefPtr<CefV8Handler> command_handler = new CommandBufferHandler();
+
+            registry.context = context;
+            registry.undefinedValue = CefV8Value::CreateUndefined();
+            registry.nullValue = CefV8Value::CreateNull();
+            registry.trueValue = CefV8Value::CreateBool(true);
+            registry.falseValue = CefV8Value::CreateBool(false);
+            growRegistry(registry);
+
+            if(extensionRegistered)
+            {
+                // The extension already defined Module in this context.
+                registry.moduleObject = context->GetGlobal()->GetValue("Module");
+            }
+            else
+            {
+                registry.moduleObject = CefV8Value::CreateObject(new ModuleAccessor(contextRegistries.back()));
+                context->GetGlobal()->SetValue("Module", registry.moduleObject, V8_PROPERTY_ATTRIBUTE_NONE);
+            }
+
+            for(int id = 0; id < int(getClasses().size()); ++id)
+            {
+                installClass(registry, id);
+            }
+
+            if(!allowedPlugins.empty())
+            {
+                registry.moduleObject->SetValue("load", CefV8Value::CreateFunction("load", plugin_handler), V8_PROPERTY_ATTRIBUTE_READONLY);
+                registry.moduleObject->SetValue("unload", CefV8Value::CreateFunction("unload", plugin_handler), V8_PROPERTY_ATTRIBUTE_READONLY);
+            }
+
+            registry.moduleObject->SetValue("__binding", CefV8Value::CreateFunction("__binding", command_handler), V8_PROPERTY_ATTRIBUTE_READONLY);
+            registry.moduleObject->SetValue("__flush", CefV8Value::CreateFunction("__flush", command_handler), V8_PROPERTY_ATTRIBUTE_READONLY);
+
+            for(auto & func : registerers)
+            {
+                func(registry);
+            }
+
+            if(proxyGlobals.size())
+            {
+                installProxies(registry);
+            }
         }
 
-        std::vector<Registerer> & getRegisterers()
+        static void closePlugin(Plugin & plugin)
         {
-            return registerers;
+            #ifdef _WIN32
+                FreeLibrary((HMODULE) plugin.handle);
+            #else
+                dlclose(plugin.handle);
+            #endif
+
+            plugin.handle = nullptr;
         }
-    #endif
 
-    void executeJavaScript(const char *str)
-    {
-        #ifdef EMSCRIPTEN
-            emscripten_run_script(str);
-        #else
-            CefRefPtr<CefFrame> frame = browser->GetMainFrame();
-            frame->ExecuteJavaScript(str, frame->GetURL(), 0);
-        #endif
-    }
+        void onContextReleased(CefV8Context *context)
+        {
+            for(auto it = contextRegistries.begin(); it != contextRegistries.end(); ++it)
+            {
+                if((*it)->context->IsSame(context))
+                {
+                    for(auto & plugin : plugins)
+                    {
+                        if(plugin.handle && plugin.unloaded && plugin.holders.erase(it->get()) && plugin.holders.empty())
+                        {
+                            closePlugin(plugin);
+                        }
+                    }
+
+                    contextRegistries.erase(it);
+                    return;
+                }
+            }
+        }
+
+        void setPluginDirectory(const char * directory)
+        {
+            pluginDirectory = directory;
+        }
+
+        void allowPlugin(const char * name)
+        {
+            allowedPlugins.insert(name);
+        }
+
+        // A plain file name: no separator or dot can reach outside the plugin directory.
+        static bool isValidPluginName(const std::string & name)
+        {
+            return !name.empty() && std::all_of(name.begin(), name.end(), [](const char c) {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+            });
+        }
+
+        bool loadPlugin(const std::string & name, std::string & error)
+        {
+            if(!isValidPluginName(name))
+            {
+                error = "embindcefv8: invalid plugin name";
+                return false;
+            }
+
+            for(auto & plugin : plugins)
+            {
+                if(plugin.name == name && plugin.handle)
+                {
+                    if(plugin.unloaded)
+                    {
+                        error = "embindcefv8: plugin " + name + " is still referenced by a context";
+                        return false;
+                    }
+
+                    return true;
+                }
+            }
+
+            #ifdef _WIN32
+                std::string path = pluginDirectory + "/" + name + ".dll";
+                void * handle = (void *) LoadLibraryA(path.c_str());
+                auto init = handle ? (void (*)()) GetProcAddress((HMODULE) handle, "embindcefv8_plugin_init") : nullptr;
+            #else
+                #ifdef __APPLE__
+                    std::string path = pluginDirectory + "/lib" + name + ".dylib";
+                #else
+                    std::string path = pluginDirectory + "/lib" + name + ".so";
+                #endif
+                void * handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+                auto init = handle ? (void (*)()) dlsym(handle, "embindcefv8_plugin_init") : nullptr;
+            #endif
+
+            if(!init)
+            {
+                error = "embindcefv8: cannot load plugin " + path;
+
+                if(handle)
+                {
+                    Plugin failed(name, handle);
+                    closePlugin(failed);
+                }
+
+                return false;
+            }
+
+            ensureBindings();
+
+            Plugin plugin(name, handle);
+
+            plugin.firstClass = int(getClasses().size());
+            plugin.firstBinding = int(getBindings().size());
+            plugin.firstValueObject = int(getValueObjects().size());
+            plugin.firstRegisterer = int(registerers.size());
+
+            init();
+
+            plugin.lastClass = int(getClasses().size());
+            plugin.lastBinding = int(getBindings().size());
+            plugin.lastValueObject = int(getValueObjects().size());
+            plugin.lastRegisterer = int(registerers.size());
+            plugins.push_back(plugin);
+            mostDerivedClasses.clear();
+
+            for(auto & registry : contextRegistries)
+            {
+                growRegistry(*registry);
+            }
+
+            installInContexts([&plugin](ContextRegistry & registry) {
+                for(int id = plugin.firstClass; id < plugin.lastClass; ++id)
+                {
+                    installClass(registry, id);
+                }
+
+                for(int i = plugin.firstRegisterer; i < plugin.lastRegisterer; ++i)
+                {
+                    registerers[i](registry);
+                }
+            });
+
+            return true;
+        }
+
+        bool unloadPlugin(const std::string & name, std::string & error)
+        {
+            auto it = std::find_if(plugins.begin(), plugins.end(), [&name](const Plugin & plugin) {
+                return plugin.name == name && plugin.handle && !plugin.unloaded;
+            });
+
+            if(it == plugins.end())
+            {
+                error = "embindcefv8: plugin " + name + " is not loaded";
+                return false;
+            }
+
+            auto & plugin = *it;
+            auto & classes = getClasses();
+            auto & bindings = getBindings();
+
+            // Every entry that points into the library is cut off; wrappers left in JS then throw on call.
+            for(int i = plugin.firstBinding; i < plugin.lastBinding; ++i)
+            {
+                bindings[i].function = nullptr;
+                bindings[i].method = nullptr;
+                bindings[i].overloads.clear();
+            }
+
+            for(int i = plugin.firstValueObject; i < plugin.lastValueObject; ++i)
+            {
+                getValueObjects()[i].fields.clear();
+            }
+
+            for(int i = plugin.firstRegisterer; i < plugin.lastRegisterer; ++i)
+            {
+                registerers[i] = [](ContextRegistry &) {};
+            }
+
+            for(int id = plugin.firstClass; id < plugin.lastClass; ++id)
+            {
+                classes[id].createConstructor = nullptr;
+                classes[id].createMethods = nullptr;
+                classes[id].getBaseId = &ClassId<void>::get;
+                classes[id].methodNames.clear();
+                classes[id].methods.clear();
+                classes[id].methodSignatures.clear();
+                classes[id].staticFunctionNames.clear();
+                classes[id].staticFunctions.clear();
+                classes[id].staticFunctionSignatures.clear();
+                classes[id].type = nullptr;
+                classes[id].wrap = nullptr;
+                classes[id].downcast = nullptr;
+                classes[id].bases.clear();
+                classes[id].ancestors.clear();
+                classes[id].ancestorsReady = true;
+            }
+
+            mostDerivedClasses.clear();
+
+            installInContexts([&plugin](ContextRegistry & registry) {
+                for(int id = plugin.firstClass; id < plugin.lastClass; ++id)
+                {
+                    registry.moduleObject->DeleteValue(getClasses()[id].name);
+                    registry.constructors[id] = nullptr;
+                    registry.methods[id].clear();
+                    registry.methodsReady[id] = true;
+                }
+            });
+
+            plugin.unloaded = true;
+
+            for(auto & registry : contextRegistries)
+            {
+                plugin.holders.insert(registry.get());
+            }
+
+            if(plugin.holders.empty())
+            {
+                closePlugin(plugin);
+            }
+
+            return true;
+        }
+
+        ContextRegistry * getContextRegistry(CefRefPtr<CefV8Context> context)
+        {
+            for(auto & registry : contextRegistries)
+            {
+                if(registry->context->IsSame(context))
+                {
+                    return registry.get();
+                }
+            }
+
+            return nullptr;
+        }
+
+        ContextRegistry * getContextRegistry()
+        {
+            if(contextRegistries.size() == 1)
+            {
+                return contextRegistries[0].get();
+            }
+
+            return CefV8Context::InContext() ? getContextRegistry(CefV8Context::GetCurrentContext()) : nullptr;
+        }
+
+        ContextRegistry * getDefaultContextRegistry()
+        {
+            ContextRegistry * registry = getContextRegistry();
+
+            // Outside V8, prefer the main frame over whichever frame (an iframe, say) was created last.
+            for(size_t i = 0; !registry && i < contextRegistries.size(); ++i)
+            {
+                CefRefPtr<CefFrame> frame = contextRegistries[i]->context->GetFrame();
+
+                if(frame && frame->IsMain())
+                {
+                    registry = contextRegistries[i].get();
+                }
+            }
+
+            if(!registry && contextRegistries.size())
+            {
+                registry = contextRegistries.front().get();
+            }
+
+            return registry;
+        }
+
+        void setIntegerCacheRange(const int minimum, const int maximum)
+        {
+            integerCacheMinimum = minimum;
+            integerCacheMaximum = std::max(minimum - 1, maximum);
+
+            for(auto & registry : contextRegistries)
+            {
+                registry->integerValues.clear();
+            }
+        }
+
+        // Registry of the context a binding call or compiled function runs in; spares the cached primitives a context lookup each.
+        static ContextRegistry
+            * callRegistry = nullptr;
+
+        static ContextRegistry * getCallRegistry()
+        {
+            return callRegistry ? callRegistry : getContextRegistry();
+        }
+
+        CefRefPtr<CefV8Value> createInt(const int value)
+        {
+            ContextRegistry * registry;
+
+            if(value < integerCacheMinimum || value > integerCacheMaximum || !(registry = getCallRegistry()))
+            {
+                return CefV8Value::CreateInt(value);
+            }
+
+            auto & values = registry->integerValues;
+            size_t index = size_t(value - integerCacheMinimum);
+
+            if(values.empty())
+            {
+                values.resize(size_t(integerCacheMaximum - integerCacheMinimum) + 1);
+            }
+
+            if(!values[index])
+            {
+                values[index] = CefV8Value::CreateInt(value);
+            }
+
+            return values[index];
+        }
+
+        CefRefPtr<CefV8Value> createUInt(const unsigned value)
+        {
+            return value <= unsigned(std::numeric_limits<int>::max()) ? createInt(int(value)) : CefV8Value::CreateUInt(value);
+        }
+
+        CefRefPtr<CefV8Value> createBool(const bool value)
+        {
+            ContextRegistry * registry = getCallRegistry();
+
+            if(!registry)
+            {
+                return CefV8Value::CreateBool(value);
+            }
+
+            return value ? registry->trueValue : registry->falseValue;
+        }
+
+        CefRefPtr<CefV8Value> createUndefined()
+        {
+            ContextRegistry * registry = getCallRegistry();
+
+            return registry ? registry->undefinedValue : CefV8Value::CreateUndefined();
+        }
+
+        CefRefPtr<CefV8Value> createNull()
+        {
+            ContextRegistry * registry = getCallRegistry();
+
+            return registry ? registry->nullValue : CefV8Value::CreateNull();
+        }
+
+        // Copies the leading ASCII run of source, returns its length.
+        static size_t copyAscii(const char * source, const size_t length, char16 * destination)
+        {
+            size_t i = 0;
+
+            #if defined(__AVX2__)
+                for(; i + 32 <= length; i += 32)
+                {
+                    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + i));
+
+                    if(_mm256_movemask_epi8(bytes))
+                    {
+                        break;
+                    }
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+                }
+            #endif
+
+            #ifdef EMBINDCEFV8_SSE2
+                const __m128i zero = _mm_setzero_si128();
+
+                for(; i + 16 <= length; i += 16)
+                {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+
+                    if(_mm_movemask_epi8(bytes))
+                    {
+                        break;
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_unpacklo_epi8(bytes, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i + 8), _mm_unpackhi_epi8(bytes, zero));
+                }
+            #endif
+
+            for(; i < length && static_cast<unsigned char>(source[i]) < 0x80; ++i)
+            {
+                destination[i] = char16(source[i]);
+            }
+
+            return i;
+        }
+
+        static size_t copyAscii(const char16 * source, const size_t length, char * destination)
+        {
+            size_t i = 0;
+
+            #if defined(__AVX2__)
+                const __m256i wide_mask = _mm256_set1_epi16(short(0xFF80));
+
+                for(; i + 32 <= length; i += 32)
+                {
+                    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + i));
+                    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + i + 16));
+
+                    if(!_mm256_testz_si256(_mm256_or_si256(low, high), wide_mask))
+                    {
+                        break;
+                    }
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i), _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8));
+                }
+            #endif
+
+            #ifdef EMBINDCEFV8_SSE2
+                const __m128i mask = _mm_set1_epi16(short(0xFF80));
+                const __m128i zero = _mm_setzero_si128();
+
+                for(; i + 16 <= length; i += 16)
+                {
+                    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+                    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i + 8));
+                    __m128i wide = _mm_and_si128(_mm_or_si128(low, high), mask);
+
+                    if(_mm_movemask_epi8(_mm_cmpeq_epi16(wide, zero)) != 0xFFFF)
+                    {
+                        break;
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), _mm_packus_epi16(low, high));
+                }
+            #endif
+
+            for(; i < length && source[i] < 0x80; ++i)
+            {
+                destination[i] = char(source[i]);
+            }
+
+            return i;
+        }
+
+        // Writes at most three bytes per UTF-16 unit; a surrogate pair takes four bytes for two units.
+        static size_t transcodeToUtf8(const char16 * source, const size_t length, char * destination)
+        {
+            size_t read = 0, written = 0;
+
+            while(read < length)
+            {
+                size_t run = copyAscii(source + read, length - read, destination + written);
+
+                read += run;
+                written += run;
+
+                if(read == length)
+                {
+                    break;
+                }
+
+                uint32 code_point = source[read++];
+
+                if(code_point >= 0xD800 && code_point <= 0xDFFF)
+                {
+                    if(code_point <= 0xDBFF && read < length && source[read] >= 0xDC00 && source[read] <= 0xDFFF)
+                    {
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (source[read++] - 0xDC00);
+                    }
+                    else
+                    {
+                        code_point = 0xFFFD;
+                    }
+                }
+
+                if(code_point < 0x800)
+                {
+                    destination[written++] = char(0xC0 | (code_point >> 6));
+                }
+                else if(code_point < 0x10000)
+                {
+                    destination[written++] = char(0xE0 | (code_point >> 12));
+                    destination[written++] = char(0x80 | ((code_point >> 6) & 0x3F));
+                }
+                else
+                {
+                    destination[written++] = char(0xF0 | (code_point >> 18));
+                    destination[written++] = char(0x80 | ((code_point >> 12) & 0x3F));
+                    destination[written++] = char(0x80 | ((code_point >> 6) & 0x3F));
+                }
+
+                destination[written++] = char(0x80 | (code_point & 0x3F));
+            }
+
+            return written;
+        }
+
+        std::string toUtf8(const CefString & value)
+        {
+            const char16 * source = value.c_str();
+            const size_t length = value.length();
+            std::string result;
+
+            result.resize(length);
+
+            size_t read = copyAscii(source, length, &result[0]);
+
+            if(read == length)
+            {
+                return result;
+            }
+
+            result.resize(read + (length - read) * 3);
+            result.resize(read + transcodeToUtf8(source + read, length - read, &result[read]));
+
+            return result;
+        }
+
+        const char * toUtf8(const CefString & value, ScratchArena & arena, size_t * size)
+        {
+            const size_t length = value.length();
+            char * result = static_cast<char *>(arena.allocate(length * 3 + 1, 1));
+            size_t written = transcodeToUtf8(value.c_str(), length, result);
+
+            result[written] = 0;
+            arena.trim(result, written + 1);
+
+            if(size)
+            {
+                *size = written;
+            }
+
+            return result;
+        }
+
+        CefString toCefString(const char * data, const size_t length)
+        {
+            // UTF-16 never needs more units than UTF-8 has bytes.
+            thread_local std::vector<char16> buffer;
+            const unsigned char * source = reinterpret_cast<const unsigned char *>(data);
+            size_t read = 0, written = 0;
+
+            if(buffer.size() < length)
+            {
+                buffer.resize(length);
+            }
+
+            char16 * destination = buffer.data();
+
+            while(read < length)
+            {
+                size_t run = copyAscii(data + read, length - read, destination + written);
+
+                read += run;
+                written += run;
+
+                if(read == length)
+                {
+                    break;
+                }
+
+                uint32 lead = source[read], code_point = 0xFFFD;
+                size_t count = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+                uint32 minimum = count == 3 ? 0x10000 : count == 2 ? 0x800 : 0x80;
+
+                if(count && lead < 0xF5 && read + count < length)
+                {
+                    uint32 decoded = lead & (0x3F >> count);
+                    size_t i = 1;
+
+                    for(; i <= count && (source[read + i] & 0xC0) == 0x80; ++i)
+                    {
+                        decoded = (decoded << 6) | (source[read + i] & 0x3F);
+                    }
+
+                    if(i > count && decoded >= minimum && decoded <= 0x10FFFF && (decoded < 0xD800 || decoded > 0xDFFF))
+                    {
+                        code_point = decoded;
+                        read += count;
+                    }
+                }
+
+                ++read;
+
+                if(code_point >= 0x10000)
+                {
+                    destination[written++] = char16(0xD800 + ((code_point - 0x10000) >> 10));
+                    destination[written++] = char16(0xDC00 + ((code_point - 0x10000) & 0x3FF));
+                }
+                else
+                {
+                    destination[written++] = char16(code_point);
+                }
+            }
+
+            return CefString(destination, written, true);
+        }
+
+        ScratchArena::~ScratchArena()
+        {
+            rewind({0, 0, 0});
+        }
+
+        void * ScratchArena::allocate(const size_t size, const size_t alignment)
+        {
+            while(true)
+            {
+                if(current < blocks.size())
+                {
+                    auto & block = blocks[current];
+                    size_t start = (offset + alignment - 1) & ~(alignment - 1);
+
+                    if(start + size <= block.size)
+                    {
+                        offset = start + size;
+                        return block.data.get() + start;
+                    }
+
+                    if(current + 1 < blocks.size() && blocks[current + 1].size >= size)
+                    {
+                        ++current;
+                        offset = 0;
+                        continue;
+                    }
+                }
+
+                // Blocks past the current one are too small for this request; replace them with one that fits.
+                const size_t block_size = std::max<size_t>(size + alignment, 64 * 1024);
+
+                blocks.resize(blocks.empty() ? 0 : current + 1);
+                blocks.push_back({std::unique_ptr<char[]>(new char[block_size]), block_size});
+                current = blocks.size() - 1;
+                offset = 0;
+            }
+        }
+
+        void ScratchArena::trim(void * last, const size_t size)
+        {
+            offset = size_t(static_cast<char *>(last) - blocks[current].data.get()) + size;
+        }
+
+        ScratchArena::Mark ScratchArena::mark() const
+        {
+            return {current, offset, destructors.size()};
+        }
+
+        void ScratchArena::rewind(const Mark & mark)
+        {
+            while(destructors.size() > mark.destructorCount)
+            {
+                auto & destructor = destructors.back();
+
+                destructor.destroy(destructor.object);
+                destructors.pop_back();
+            }
+
+            current = mark.block;
+            offset = mark.offset;
+        }
+
+        ScratchArena & getScratchArena()
+        {
+            thread_local ScratchArena arena;
+
+            return arena;
+        }
+
+        void installInContexts(const Registerer & registerer)
+        {
+            for(auto & registry : contextRegistries)
+            {
+                if(registry->context->Enter())
+                {
+                    registerer(*registry);
+                    registry->context->Exit();
+                }
+            }
+        }
+
+        void setBrowser(CefRefPtr<CefBrowser> _browser)
+        {
+            browser = _browser;
+        }
+
+        bool hasContext()
+        {
+            return !contextRegistries.empty();
+        }
+
+        CefRefPtr<CefV8Value> & getModuleObject()
+        {
+            static CefRefPtr<CefV8Value>
+                none;
+            ContextRegistry * registry = getDefaultContextRegistry();
+
+            return registry ? registry->moduleObject : none;
+        }
+
+        std::vector<Registerer> & getRegisterers()
+        {
+            return registerers;
+        }
+
+        std::vector<ClassInfo> & getClasses()
+        {
+            static std::vector<ClassInfo>
+                classes;
+
+            return classes;
+        }
+
+        unsigned & getPropertyGeneration()
+        {
+            static unsigned
+                generation = 1;
+
+            return generation;
+        }
+
+        std::vector<Binding> & getBindings()
+        {
+            static std::vector<Binding>
+                bindings;
+
+            return bindings;
+        }
+
+        int addBinding(const Binding & binding)
+        {
+            getBindings().push_back(binding);
+
+            return int(getBindings().size()) - 1;
+        }
+
+        void addOverload(const int id, const BindingOverload & overload)
+        {
+            auto & binding = getBindings()[id];
+            auto it = std::find_if(binding.overloads.begin(), binding.overloads.end(), [&overload](const BindingOverload & other) {
+                return other.arity == overload.arity && other.matches == overload.matches;
+            });
+
+            if(it != binding.overloads.end())
+            {
+                *it = overload;
+            }
+            else
+            {
+                binding.overloads.push_back(overload);
+            }
+
+            // A single signature is called directly, without dispatch.
+            if(binding.overloads.size() == 1)
+            {
+                binding.function = overload.function ? overload.function : binding.function;
+                binding.method = overload.method ? overload.method : binding.method;
+            }
+        }
+
+        void setArgumentValidation(const bool enabled)
+        {
+            argumentValidation = enabled;
+        }
+
+        // Thrown through a rethrowing JavaScript helper, since a handler's exception string always becomes an Error.
+        static void throwTypeError(const std::string & message, CefString & exception)
+        {
+            ContextRegistry * registry = getContextRegistry();
+
+            if(registry && !registry->typeErrorFunction)
+            {
+                CefRefPtr<CefV8Exception> eval_exception;
+
+                if(!registry->context->Eval("(function(message) { throw new TypeError(message); })", registry->typeErrorFunction, eval_exception))
+                {
+                    registry->typeErrorFunction = nullptr;
+                }
+                else
+                {
+                    registry->typeErrorFunction->SetRethrowExceptions(true);
+                }
+            }
+
+            if(!registry || !registry->typeErrorFunction)
+            {
+                exception = "TypeError: " + message;
+                return;
+            }
+
+            registry->typeErrorFunction->ExecuteFunction(nullptr, {CefV8Value::CreateString(message)});
+        }
+
+        // Exception string of the binding call in progress, for errors raised from inside bound functions.
+        static CefString
+            * callException = nullptr;
+
+        // Publishes the exception string and context registry of a binding call to everything it reaches.
+        class CallScope
+        {
+        public:
+            CallScope(CefString & exception)
+                :
+                outerException(callException),
+                outerRegistry(callRegistry)
+            {
+                callException = &exception;
+                callRegistry = getContextRegistry();
+            }
+
+            ~CallScope()
+            {
+                callException = outerException;
+                callRegistry = outerRegistry;
+            }
+
+        private:
+            CefString
+                * outerException;
+            ContextRegistry
+                * outerRegistry;
+        };
+
+        void throwTypeError(const std::string & message)
+        {
+            CefString ignored;
+
+            throwTypeError(message, callException ? *callException : ignored);
+        }
+
+        static unsigned char argumentKind(const CefRefPtr<CefV8Value> & value)
+        {
+            if(value->IsDouble())
+            {
+                return ARGUMENT_NUMBER;
+            }
+
+            if(value->IsBool())
+            {
+                return ARGUMENT_BOOL;
+            }
+
+            if(value->IsString())
+            {
+                return ARGUMENT_STRING;
+            }
+
+            return value->IsObject() ? ARGUMENT_OBJECT : 0;
+        }
+
+        static bool validateArguments(const Binding & binding, const BindingOverload & overload, const CefV8ValueList& arguments, CefString & exception)
+        {
+            if(!overload.kinds)
+            {
+                return true;
+            }
+
+            for(int i = 0; i < overload.arity; ++i)
+            {
+                if(!(argumentKind(arguments[i]) & overload.kinds[i]))
+                {
+                    throwTypeError("argument " + std::to_string(i + 1) + " of " + binding.name + " has the wrong type", exception);
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Missing arguments would be read out of bounds and converters dereference wrapped pointers, so these run even without validation; extra arguments are ignored as JavaScript does.
+        static bool checkArguments(const Binding & binding, const BindingOverload & overload, const CefV8ValueList& arguments, CefString & exception)
+        {
+            if(int(arguments.size()) < overload.arity)
+            {
+                throwTypeError(binding.name + " expects " + std::to_string(overload.arity) + " arguments, got " + std::to_string(arguments.size()), exception);
+                return false;
+            }
+
+            for(int i = 0; overload.classes && i < overload.arity; ++i)
+            {
+                if(overload.classes[i] && !isInstanceOf(arguments[i], overload.classes[i]()))
+                {
+                    const int class_id = overload.classes[i]();
+
+                    throwTypeError("argument " + std::to_string(i + 1) + " of " + binding.name + " is not a " + (class_id >= 0 ? getClasses()[class_id].name : std::string("registered class")), exception);
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // First overload whose arity and argument types match; without validation, a lone overload of the right arity also takes mismatched types.
+        static const BindingOverload * findOverload(const Binding & binding, const CefV8ValueList& arguments)
+        {
+            const int count = int(arguments.size());
+            const BindingOverload * same_arity = nullptr;
+            int same_arity_count = 0;
+
+            for(auto & overload : binding.overloads)
+            {
+                if(overload.arity >= 0 && overload.arity != count)
+                {
+                    continue;
+                }
+
+                if(!overload.matches || overload.matches(arguments))
+                {
+                    return &overload;
+                }
+
+                same_arity = &overload;
+                ++same_arity_count;
+            }
+
+            return !argumentValidation && same_arity_count == 1 ? same_arity : nullptr;
+        }
+
+        // Picks the overload for arguments and runs the argument checks; function and method are left alone for a single signature.
+        static bool selectOverload(const Binding & binding, const CefV8ValueList& arguments, const ResultFunction * & function, const MethodFunction * & method, CefString & exception)
+        {
+            const BindingOverload * overload = binding.overloads.size() == 1 ? &binding.overloads[0] : nullptr;
+
+            if(binding.overloads.size() > 1)
+            {
+                overload = findOverload(binding, arguments);
+
+                if(!overload)
+                {
+                    throwTypeError("no overload of " + binding.name + " takes these arguments", exception);
+                    return false;
+                }
+
+                function = &overload->function;
+                method = &overload->method;
+            }
+
+            if(overload && !checkArguments(binding, *overload, arguments, exception))
+            {
+                return false;
+            }
+
+            return !overload || !argumentValidation || validateArguments(binding, *overload, arguments, exception);
+        }
+
+        bool invokeBinding(const int id, const CefRefPtr<CefV8Value> & object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception)
+        {
+            auto & bindings = getBindings();
+
+            if(id < 0 || id >= int(bindings.size()))
+            {
+                exception = "embindcefv8: unknown binding";
+                return false;
+            }
+
+            auto & binding = bindings[id];
+            ScratchScope scratch_scope;
+            CallScope call_scope(exception);
+
+            if(!binding.function && !binding.method)
+            {
+                // A class registered without constructor() still exposes Module.<name> for its static functions.
+                if(binding.kind == BindingKind::Constructor && getClasses()[binding.classId].createConstructor)
+                {
+                    throwTypeError(binding.name + " has no constructor", exception);
+                }
+                else
+                {
+                    exception = "embindcefv8: " + binding.name + " belongs to an unloaded plugin";
+                }
+
+                return false;
+            }
+
+            const ResultFunction * function = &binding.function;
+            const MethodFunction * method = &binding.method;
+
+            if(!selectOverload(binding, arguments, function, method, exception))
+            {
+                return false;
+            }
+
+            void * target = nullptr;
+
+            if(binding.kind == BindingKind::Method)
+            {
+                UserData * data = object && object->IsObject() ? dynamic_cast<UserData*>(object->GetUserData().get()) : nullptr;
+
+                target = data ? getObject(*data, binding.classId) : nullptr;
+
+                if(!target)
+                {
+                    throwTypeError(binding.name + " called on an object that is not a " + getClasses()[binding.classId].name, exception);
+                    return false;
+                }
+            }
+
+            if(binding.kind == BindingKind::Method)
+            {
+                (*method)(retval, target, arguments);
+            }
+            else
+            {
+                (*function)(retval, arguments);
+            }
+
+            return true;
+        }
+
+        void invokeOnArray(const int id, const CefRefPtr<CefV8Value> & objects, const CefV8ValueList& arguments, const bool collect, CefRefPtr<CefV8Value>& retval)
+        {
+            CefString ignored;
+            CefString & exception = callException ? *callException : ignored;
+            auto & binding = getBindings()[id];
+            const ResultFunction * function = &binding.function;
+            const MethodFunction * method = &binding.method;
+
+            if(!*method)
+            {
+                exception = "embindcefv8: " + binding.name + " belongs to an unloaded plugin";
+                return;
+            }
+
+            if(!selectOverload(binding, arguments, function, method, exception))
+            {
+                return;
+            }
+
+            const int count = objects->GetArrayLength();
+            std::vector<void *> targets(count);
+
+            // Every element is checked before the first call, so a rejected array has no side effects.
+            for(int i = 0; i < count; ++i)
+            {
+                CefRefPtr<CefV8Value> object = objects->GetValue(i);
+                UserData * data = object->IsObject() ? dynamic_cast<UserData*>(object->GetUserData().get()) : nullptr;
+
+                targets[i] = data ? getObject(*data, binding.classId) : nullptr;
+
+                if(!targets[i])
+                {
+                    throwTypeError("element " + std::to_string(i) + " is not a " + getClasses()[binding.classId].name, exception);
+                    return;
+                }
+            }
+
+            if(collect)
+            {
+                retval = CefV8Value::CreateArray(count);
+            }
+
+            for(int i = 0; i < count; ++i)
+            {
+                CefRefPtr<CefV8Value> result;
+
+                (*method)(result, targets[i], arguments);
+
+                if(collect)
+                {
+                    retval->SetValue(i, result ? result : createUndefined());
+                }
+            }
+        }
+
+        // Shared by every function object created for the same binding, in every context.
+        class BindingHandler : public CefV8Handler
+        {
+        public:
+            BindingHandler(const int _id)
+                :
+                CefV8Handler(),
+                id(_id)
+            {
+            }
+
+            virtual bool Execute(const CefString& name, CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception) override
+            {
+                invokeBinding(id, object, arguments, retval, exception);
+                return true;
+            }
+
+            IMPLEMENT_REFCOUNTING(BindingHandler);
+        private:
+            int
+                id;
+        };
+
+        CefRefPtr<CefV8Value> createBindingFunction(const int id)
+        {
+            auto & binding = getBindings()[id];
+
+            if(!binding.handler)
+            {
+                binding.handler = new BindingHandler(id);
+            }
+
+            return CefV8Value::CreateFunction(binding.name, binding.handler);
+        }
+
+        // Single native entry point of the extension: call(binding_id, this, [arguments...]).
+        class ExtensionHandler : public CefV8Handler
+        {
+        public:
+            virtual bool Execute(const CefString& name, CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception) override
+            {
+                if(arguments.size() != 3 || !arguments[0]->IsInt() || !arguments[2]->IsArray())
+                {
+                    exception = "embindcefv8: invalid binding call";
+                    return true;
+                }
+
+                CefV8ValueList binding_arguments;
+                int count = arguments[2]->GetArrayLength();
+
+                binding_arguments.reserve(count);
+
+                for(int i = 0; i < count; ++i)
+                {
+                    binding_arguments.push_back(arguments[2]->GetValue(i));
+                }
+
+                invokeBinding(arguments[0]->GetIntValue(), arguments[1], binding_arguments, retval, exception);
+                return true;
+            }
+
+            IMPLEMENT_REFCOUNTING(ExtensionHandler);
+        };
+
+        static std::string quoteName(const std::string & name)
+        {
+            std::string result = "'";
+
+            for(char c : name)
+            {
+                if(c == '\\' || c == '\'')
+                {
+                    result += '\\';
+                }
+
+                result += c;
+            }
+
+            return result + "'";
+        }
+
+        void registerExtension()
+        {
+            ensureBindings();
+
+            auto & bindings = getBindings();
+            auto & classes = getClasses();
+            std::string code =
+                "var Module = {};"
+                "(function() {"
+                "    native function call();"
+                "    var slice = Array.prototype.slice;"
+                "    var bind = function(id) { return function() { return call(id, this, slice.call(arguments)); }; };"
+                "    var methods = [];"
+                "    Object.defineProperty(Module, '__methods', { value: methods });";
+
+            for(size_t i = 0; i < bindings.size(); ++i)
+            {
+                auto & binding = bindings[i];
+                std::string id = std::to_string(i);
+
+                switch(binding.kind)
+                {
+                    case BindingKind::Constructor:
+                        code += "Module[" + quoteName(classes[binding.classId].name) + "] = bind(" + id + ");";
+                        code += "methods[" + std::to_string(binding.classId) + "] = {};";
+                        break;
+
+                    case BindingKind::Function:
+                        code += binding.classId < 0 ? std::string("Module") : "Module[" + quoteName(classes[binding.classId].name) + "]";
+                        code += "[" + quoteName(binding.name) + "] = bind(" + id + ");";
+                        break;
+
+                    case BindingKind::Method:
+                        code += "methods[" + std::to_string(binding.classId) + "][" + quoteName(binding.name) + "] = bind(" + id + ");";
+                        break;
+                }
+            }
+
+            code += "})();";
+
+            extensionRegistered = true;
+            extensionClassCount = int(classes.size());
+            extensionBindingCount = int(bindings.size());
+            CefRegisterExtension("v8/embindcefv8", code, new ExtensionHandler());
+        }
+
+        bool isExtensionClass(const int class_id)
+        {
+            return extensionRegistered && class_id < extensionClassCount;
+        }
+
+        bool isExtensionBinding(const int binding_id)
+        {
+            return extensionRegistered && binding_id < extensionBindingCount;
+        }
+
+        void loadExtensionMethods(ContextRegistry & registry, const int class_id)
+        {
+            CefRefPtr<CefV8Value> table = registry.moduleObject->GetValue("__methods")->GetValue(class_id);
+
+            if(!table || !table->IsObject())
+            {
+                return;
+            }
+
+            std::vector<CefString> keys;
+            auto & context_methods = registry.methods[class_id];
+
+            table->GetKeys(keys);
+
+            for(auto & key : keys)
+            {
+                context_methods[key] = table->GetValue(key);
+            }
+        }
+
+        template<typename F>
+        static F & fieldAt(void * object, const size_t offset)
+        {
+            return * reinterpret_cast<F *>(static_cast<char *>(object) + offset);
+        }
+
+        void readProperty(const ClassProperty & property, void * object, CefRefPtr<CefV8Value>& retval)
+        {
+            switch(property.type)
+            {
+                case FieldType::Bool: retval = createBool(fieldAt<bool>(object, property.offset)); break;
+                case FieldType::Int: retval = createInt(fieldAt<int>(object, property.offset)); break;
+                case FieldType::Unsigned: retval = createUInt(fieldAt<unsigned int>(object, property.offset)); break;
+                case FieldType::Float: retval = CefV8Value::CreateDouble(fieldAt<float>(object, property.offset)); break;
+                case FieldType::Double: retval = CefV8Value::CreateDouble(fieldAt<double>(object, property.offset)); break;
+                case FieldType::String: retval = CefV8Value::CreateString(toCefString(fieldAt<std::string>(object, property.offset))); break;
+                case FieldType::Other: property.get(retval, object); break;
+            }
+        }
+
+        bool writeProperty(const ClassProperty & property, void * object, const CefRefPtr<CefV8Value>& value)
+        {
+            switch(property.type)
+            {
+                case FieldType::Bool:
+                    if(!value->IsBool())
+                    {
+                        return false;
+                    }
+
+                    fieldAt<bool>(object, property.offset) = value->GetBoolValue();
+                    return true;
+
+                case FieldType::Int:
+                case FieldType::Unsigned:
+                case FieldType::Float:
+                case FieldType::Double:
+                    if(!value->IsDouble())
+                    {
+                        return false;
+                    }
+
+                    switch(property.type)
+                    {
+                        case FieldType::Int: fieldAt<int>(object, property.offset) = value->GetIntValue(); break;
+                        case FieldType::Unsigned: fieldAt<unsigned int>(object, property.offset) = value->GetUIntValue(); break;
+                        case FieldType::Float: fieldAt<float>(object, property.offset) = float(value->GetDoubleValue()); break;
+                        default: fieldAt<double>(object, property.offset) = value->GetDoubleValue(); break;
+                    }
+
+                    return true;
+
+                case FieldType::String:
+                    if(!value->IsString())
+                    {
+                        return false;
+                    }
+
+                    fieldAt<std::string>(object, property.offset) = toUtf8(value->GetStringValue());
+                    return true;
+
+                case FieldType::Other:
+                    if(!property.accepts(value))
+                    {
+                        return false;
+                    }
+
+                    property.set(object, value);
+                    return true;
+            }
+
+            return false;
+        }
+
+        int findClass(const std::string & name)
+        {
+            static std::map<std::string, int>
+                index;
+            static int
+                indexed = 0;
+            auto & classes = getClasses();
+
+            for(; indexed < int(classes.size()); ++indexed)
+            {
+                index[classes[indexed].name] = indexed;
+            }
+
+            auto it = index.find(name);
+
+            // Classes of unloaded plugins keep their id but can no longer be found.
+            return it != index.end() && classes[it->second].createConstructor ? it->second : -1;
+        }
+
+        // Walks down from class_id to derived_id, one dynamic_cast per level.
+        static const void * downcastTo(const void * object, const int class_id, const int derived_id)
+        {
+            auto & classes = getClasses();
+            std::vector<int> path;
+
+            for(int id = derived_id; id != class_id; id = classes[id].getBaseId())
+            {
+                if(id < 0)
+                {
+                    return nullptr;
+                }
+
+                path.push_back(id);
+            }
+
+            for(auto it = path.rbegin(); it != path.rend() && object; ++it)
+            {
+                object = classes[*it].downcast ? classes[*it].downcast(object) : nullptr;
+            }
+
+            return object;
+        }
+
+        static void collectAncestors(std::vector<std::pair<int, std::ptrdiff_t>> & ancestors, const int class_id, const std::ptrdiff_t offset)
+        {
+            for(auto & base : getClasses()[class_id].bases)
+            {
+                const int base_id = base.first();
+
+                // Repeated bases are ambiguous in C++ too: the first path declared wins.
+                if(base_id >= 0 && std::none_of(ancestors.begin(), ancestors.end(), [base_id](const std::pair<int, std::ptrdiff_t> & ancestor) { return ancestor.first == base_id; }))
+                {
+                    ancestors.push_back({base_id, offset + base.second});
+                    collectAncestors(ancestors, base_id, offset + base.second);
+                }
+            }
+        }
+
+        void * upcastObject(void * object, const int class_id, const int base_id)
+        {
+            auto & classes = getClasses();
+
+            if(class_id < 0 || base_id < 0 || class_id >= int(classes.size()) || base_id >= int(classes.size()))
+            {
+                return nullptr;
+            }
+
+            auto & info = classes[class_id];
+
+            if(!info.ancestorsReady)
+            {
+                collectAncestors(info.ancestors, class_id, 0);
+                info.ancestorsReady = true;
+            }
+
+            for(auto & ancestor : info.ancestors)
+            {
+                if(ancestor.first == base_id)
+                {
+                    return static_cast<char *>(object) + ancestor.second;
+                }
+            }
+
+            return nullptr;
+        }
+
+        bool isInstanceOf(const CefRefPtr<CefV8Value> & value, const int class_id)
+        {
+            UserData * data = value->IsObject() ? dynamic_cast<UserData*>(value->GetUserData().get()) : nullptr;
+
+            return data && data->data && getObject(*data, class_id);
+        }
+
+        bool wrapMostDerived(CefRefPtr<CefV8Value>& retval, const void * object, const void * complete_object, const std::type_info & type, const int class_id)
+        {
+            auto & classes = getClasses();
+            auto it = mostDerivedClasses.find(type);
+            int found = -1;
+
+            if(it != mostDerivedClasses.end())
+            {
+                found = it->second;
+            }
+            else
+            {
+                int depth = 0;
+
+                for(int id = 0; id < int(classes.size()); ++id)
+                {
+                    if(classes[id].type && *classes[id].type == type)
+                    {
+                        found = id;
+                        break;
+                    }
+                }
+
+                // The dynamic type itself is not registered: take the deepest registered class the object still casts to.
+                for(int id = 0; found < 0 && id < int(classes.size()); ++id)
+                {
+                    int level = 0, base = id;
+
+                    for(; base >= 0 && base != class_id; base = classes[base].getBaseId())
+                    {
+                        ++level;
+                    }
+
+                    if(base == class_id && level > depth && classes[id].wrap && downcastTo(object, class_id, id))
+                    {
+                        depth = level;
+                        found = id;
+                    }
+                }
+
+                mostDerivedClasses[type] = found;
+            }
+
+            if(found < 0 || found == class_id)
+            {
+                return false;
+            }
+
+            const void * derived = *classes[found].type == type ? complete_object : downcastTo(object, class_id, found);
+
+            if(!derived)
+            {
+                return false;
+            }
+
+            classes[found].wrap(retval, derived);
+
+            return true;
+        }
+
+        std::vector<ValueObjectInfo> & getValueObjects()
+        {
+            static std::vector<ValueObjectInfo>
+                valueObjects;
+
+            return valueObjects;
+        }
+
+        double getListNumber(CefListValue & list, const int index)
+        {
+            switch(list.GetType(index))
+            {
+                case VTYPE_BOOL: return list.GetBool(index);
+                case VTYPE_INT: return list.GetInt(index);
+                case VTYPE_DOUBLE: return list.GetDouble(index);
+                default: return 0.0;
+            }
+        }
+
+        // Class metadata is built once per process; contexts only install it.
+        void ensureBindings()
+        {
+            if(bindingsReady)
+            {
+                return;
+            }
+
+            bindingsReady = true;
+
+            #ifdef EMBINDCEFV8_SECTION
+                // Link order, no allocation; identical in every process running this binary.
+                for(const InitializerEntry * entry = EMBINDCEFV8_SECTION_START; entry != EMBINDCEFV8_SECTION_STOP; ++entry)
+                {
+                    entry->init();
+                }
+            #endif
+
+            for(auto& kv : getInitializers())
+            {
+                kv.second();
+            }
+        }
+
+        int getProxyHandle(void * data, const int class_id)
+        {
+            auto it = proxyHandles.find({data, class_id});
+
+            if(it != proxyHandles.end())
+            {
+                return it->second;
+            }
+
+            const int handle = int(proxyObjects.size());
+            proxyObjects.push_back({data, class_id});
+            proxyHandles[{data, class_id}] = handle;
+
+            return handle;
+        }
+
+        void * getProxyObject(const int handle, const int class_id)
+        {
+            if(handle < 0 || handle >= int(proxyObjects.size()) || !proxyObjects[handle].object)
+            {
+                return nullptr;
+            }
+
+            auto & entry = proxyObjects[handle];
+
+            return entry.classId == class_id ? entry.object : upcastObject(entry.object, entry.classId, class_id);
+        }
+
+        void removeProxyObject(void * data, const int class_id)
+        {
+            // The object may have been handed out as any of its classes, each at its own address.
+            for(auto it = proxyHandles.begin(); it != proxyHandles.end();)
+            {
+                const int handle = it->second;
+                auto & entry = proxyObjects[handle];
+
+                if((entry.object == data && entry.classId == class_id) || upcastObject(data, class_id, entry.classId) == entry.object || upcastObject(entry.object, entry.classId, class_id) == data)
+                {
+                    entry = {nullptr, -1};
+                    proxyGlobals.erase(std::remove_if(proxyGlobals.begin(), proxyGlobals.end(), [handle](const ProxyGlobal & global) { return global.handle == handle; }), proxyGlobals.end());
+                    it = proxyHandles.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        void addProxyGlobal(const char * name, const int handle, const int class_id)
+        {
+            proxyGlobals.push_back({name, handle, class_id});
+        }
+
+        void onRenderProcessThreadCreated(CefRefPtr<CefListValue> extra_info)
+        {
+            if(proxyGlobals.empty())
+            {
+                return;
+            }
+
+            CefRefPtr<CefListValue> info = CefListValue::Create();
+            int index = 0;
+
+            info->SetString(index++, proxyInfoMarker);
+
+            for(auto & global : proxyGlobals)
+            {
+                info->SetString(index++, global.name);
+                info->SetInt(index++, global.handle);
+                info->SetInt(index++, global.classId);
+            }
+
+            extra_info->SetList(extra_info->GetSize(), info);
+        }
+
+        void onRenderThreadCreated(CefRefPtr<CefListValue> extra_info)
+        {
+            for(size_t i = 0; i < extra_info->GetSize(); ++i)
+            {
+                if(extra_info->GetType(i) != VTYPE_LIST)
+                {
+                    continue;
+                }
+
+                CefRefPtr<CefListValue> info = extra_info->GetList(i);
+
+                if(info->GetSize() == 0 || info->GetType(0) != VTYPE_STRING || info->GetString(0) != proxyInfoMarker)
+                {
+                    continue;
+                }
+
+                proxyGlobals.clear();
+
+                for(size_t j = 1; j + 2 < info->GetSize(); j += 3)
+                {
+                    proxyGlobals.push_back({info->GetString(j).ToString(), info->GetInt(j + 1), info->GetInt(j + 2)});
+                }
+            }
+        }
+
+        static bool dispatchProxyCall(WireWriter & writer, WireReader & reader, std::string & error)
+        {
+            const int kind = int(reader.readVarUInt());
+            const int handle = int(reader.readVarUInt());
+            const int class_id = int(reader.readVarUInt());
+            const int index = int(reader.readVarUInt());
+            const int argument_count = int(reader.readVarUInt());
+            auto & classes = getClasses();
+
+            if(!reader.isValid() || class_id < 0 || class_id >= int(classes.size()))
+            {
+                error = "embindcefv8: unknown proxy class";
+                return false;
+            }
+
+            auto & info = classes[class_id];
+
+            if(kind == PROXY_CALL_METHOD)
+            {
+                // The class comes from the renderer: it must be the registered class of the handle or one of its ancestors.
+                void * object = getProxyObject(handle, class_id);
+
+                if(!object)
+                {
+                    error = "embindcefv8: no " + info.name + " proxy object with this handle";
+                    return false;
+                }
+
+                if(index < 0 || index >= int(info.methods.size()))
+                {
+                    error = "embindcefv8: unknown method on " + info.name;
+                    return false;
+                }
+
+                if(!info.methods[index](writer, object, reader, argument_count))
+                {
+                    error = "embindcefv8: invalid call to " + info.name + "." + info.methodNames[index];
+                    return false;
+                }
+
+                return true;
+            }
+
+            if(index < 0 || index >= int(info.staticFunctions.size()))
+            {
+                error = "embindcefv8: unknown static function on " + info.name;
+                return false;
+            }
+
+            if(!info.staticFunctions[index](writer, reader, argument_count))
+            {
+                error = "embindcefv8: invalid call to " + info.name + "." + info.staticFunctionNames[index];
+                return false;
+            }
+
+            return true;
+        }
+
+        static void processProxyCalls(CefRefPtr<CefBrowser> browser_, CefRefPtr<CefBinaryValue> calls)
+        {
+            std::vector<char> data(calls->GetSize());
+            calls->GetData(data.data(), data.size(), 0);
+
+            WireReader reader(data.data(), data.size());
+            WireWriter replies;
+            WireWriter result;
+            std::string error;
+
+            while(!reader.atEnd() && reader.isValid())
+            {
+                const uint32 call_id = reader.readVarUInt();
+                const uint32 length = reader.readVarUInt();
+
+                if(!reader.isValid() || length > reader.getRemaining())
+                {
+                    break;
+                }
+
+                WireReader call_reader(reader.getPosition(), length);
+                reader.skipBytes(length);
+
+                result.clear();
+                error.clear();
+
+                if(dispatchProxyCall(result, call_reader, error))
+                {
+                    replies.writeVarUInt(call_id);
+                    replies.writeVarUInt(1);
+                    replies.append(result);
+                }
+                else
+                {
+                    replies.writeVarUInt(call_id);
+                    replies.writeVarUInt(0);
+                    replies.writeString(error);
+                }
+            }
+
+            CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create(proxyRepliesMessage);
+            message->GetArgumentList()->SetBinary(0, CefBinaryValue::Create(replies.getData(), replies.getSize()));
+            browser_->SendProcessMessage(PID_RENDERER, message);
+        }
+
+        static CefRefPtr<CefV8Value> createProxyObject(const int handle, const int class_id);
+
+        static CefRefPtr<CefV8Value> readV8Value(WireReader & reader)
+        {
+            switch(reader.peekTag())
+            {
+                case WireTag::Bool: return CefV8Value::CreateBool(reader.readBool());
+                case WireTag::Int: return CefV8Value::CreateInt(reader.readInt());
+                case WireTag::UInt: return CefV8Value::CreateUInt(reader.readUInt());
+                case WireTag::Double: return CefV8Value::CreateDouble(reader.readDouble());
+                case WireTag::String: return CefV8Value::CreateString(toCefString(reader.readString()));
+
+                case WireTag::Handle:
+                {
+                    int
+                        handle,
+                        class_id;
+
+                    if(reader.readRawHandle(handle, class_id))
+                    {
+                        return createProxyObject(handle, class_id);
+                    }
+
+                    return CefV8Value::CreateUndefined();
+                }
+
+                case WireTag::Object:
+                {
+                    int
+                        type_id;
+                    uint32
+                        count;
+                    auto & value_objects = getValueObjects();
+                    WireReader::Nesting nesting(reader);
+
+                    if(!reader.isValid() || !reader.readObjectHeader(type_id, count) || type_id < 0 || type_id >= int(value_objects.size()))
+                    {
+                        reader.fail();
+                        return CefV8Value::CreateUndefined();
+                    }
+
+                    auto & fields = value_objects[type_id].fields;
+                    CefRefPtr<CefV8Value> result = CefV8Value::CreateObject(nullptr);
+
+                    for(uint32 i = 0; i < count && reader.isValid(); ++i)
+                    {
+                        CefRefPtr<CefV8Value> field_value = readV8Value(reader);
+
+                        if(i < fields.size())
+                        {
+                            result->SetValue(fields[i].name, field_value, V8_PROPERTY_ATTRIBUTE_NONE);
+                        }
+                    }
+
+                    return result;
+                }
+
+                case WireTag::Array:
+                {
+                    uint32
+                        count;
+                    WireReader::Nesting nesting(reader);
+
+                    if(!reader.isValid() || !reader.readArrayHeader(count))
+                    {
+                        return CefV8Value::CreateUndefined();
+                    }
+
+                    CefRefPtr<CefV8Value> result = CefV8Value::CreateArray(int(std::min<size_t>(count, reader.getRemaining())));
+
+                    for(uint32 i = 0; i < count && reader.isValid(); ++i)
+                    {
+                        result->SetValue(int(i), readV8Value(reader));
+                    }
+
+                    return result;
+                }
+
+                default:
+                    reader.skipValue();
+                    return CefV8Value::CreateUndefined();
+            }
+        }
+
+        // object_id names the value object the browser expects here, so plain objects can be written in its field order.
+        static bool writeV8Value(WireWriter & writer, const CefRefPtr<CefV8Value> & value, const WireIdFunction object_id)
+        {
+            if(value->IsUndefined() || value->IsNull())
+            {
+                writer.writeUndefined();
+            }
+            else if(value->IsBool())
+            {
+                writer.writeBool(value->GetBoolValue());
+            }
+            else if(value->IsInt())
+            {
+                writer.writeInt(value->GetIntValue());
+            }
+            else if(value->IsUInt())
+            {
+                writer.writeUInt(value->GetUIntValue());
+            }
+            else if(value->IsDouble())
+            {
+                writer.writeDouble(value->GetDoubleValue());
+            }
+            else if(value->IsString())
+            {
+                writer.writeString(toUtf8(value->GetStringValue()));
+            }
+            else if(value->IsArray())
+            {
+                const int length = value->GetArrayLength();
+
+                writer.writeArrayHeader(length);
+
+                for(int i = 0; i < length; ++i)
+                {
+                    if(!writeV8Value(writer, value->GetValue(i), object_id))
+                    {
+                        return false;
+                    }
+                }
+            }
+            else if(value->IsObject() && !value->IsFunction())
+            {
+                ProxyData * data = dynamic_cast<ProxyData *>(value->GetUserData().get());
+
+                if(data)
+                {
+                    writer.writeHandle(data->handle, data->classId);
+                    return true;
+                }
+
+                if(!object_id)
+                {
+                    return false;
+                }
+
+                const int type_id = object_id();
+                auto & value_objects = getValueObjects();
+
+                if(type_id < 0 || type_id >= int(value_objects.size()))
+                {
+                    return false;
+                }
+
+                auto & fields = value_objects[type_id].fields;
+                writer.writeObjectHeader(type_id, fields.size());
+
+                for(auto & field : fields)
+                {
+                    if(!value->HasValue(field.name))
+                    {
+                        writer.writeUndefined();
+                    }
+                    else if(!writeV8Value(writer, value->GetValue(field.name), field.objectId))
+                    {
+                        return false;
+                    }
+                }
+            }
+            else
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        static void processProxyReplies(CefRefPtr<CefBinaryValue> replies)
+        {
+            std::vector<char> data(replies->GetSize());
+            replies->GetData(data.data(), data.size(), 0);
+
+            WireReader reader(data.data(), data.size());
+
+            while(!reader.atEnd() && reader.isValid())
+            {
+                const uint32 call_id = reader.readVarUInt();
+                const bool success = reader.readVarUInt() != 0;
+                auto it = pendingProxyCalls.find(call_id);
+
+                if(it == pendingProxyCalls.end() || !it->second.context->IsValid())
+                {
+                    reader.skipValue();
+
+                    if(it != pendingProxyCalls.end())
+                    {
+                        pendingProxyCalls.erase(it);
+                    }
+
+                    continue;
+                }
+
+                PendingProxyCall call = it->second;
+                pendingProxyCalls.erase(it);
+
+                call.context->Enter();
+
+                CefV8ValueList arguments;
+                arguments.push_back(readV8Value(reader));
+
+                (success ? call.resolve : call.reject)->ExecuteFunction(nullptr, arguments);
+
+                call.context->Exit();
+            }
+        }
+
+        class ProxyFlushTask : public CefTask
+        {
+        public:
+            virtual void Execute() override
+            {
+                proxyFlushScheduled = false;
+
+                for(auto & kv : proxyBatches)
+                {
+                    auto & batch = kv.second;
+
+                    if(batch.writer.getSize() == 0)
+                    {
+                        continue;
+                    }
+
+                    CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create(proxyCallsMessage);
+                    message->GetArgumentList()->SetBinary(0, CefBinaryValue::Create(batch.writer.getData(), batch.writer.getSize()));
+                    batch.browser->SendProcessMessage(PID_BROWSER, message);
+                    batch.writer.clear();
+                }
+            }
+
+            IMPLEMENT_REFCOUNTING(ProxyFlushTask);
+        };
+
+        // Same choice as findOverload among the proxy entries named like index; index itself when none fits, for the browser to reject.
+        static int findProxyOverload(const std::vector<std::string> & names, const std::vector<ProxySignature> & signatures, const int index, const CefV8ValueList& arguments)
+        {
+            int
+                same_arity = -1,
+                same_arity_count = 0;
+
+            if(index < 0 || size_t(index) >= names.size() || names.size() != signatures.size())
+            {
+                return -1;
+            }
+
+            for(size_t i = 0; i < names.size(); ++i)
+            {
+                auto & signature = signatures[i];
+
+                if(signature.objects.size() != arguments.size() || names[i] != names[index])
+                {
+                    continue;
+                }
+
+                bool matches = true;
+
+                for(size_t j = 0; j < arguments.size() && matches; ++j)
+                {
+                    matches = (argumentKind(arguments[j]) & signature.kinds[j]) != 0;
+                }
+
+                if(matches)
+                {
+                    return int(i);
+                }
+
+                same_arity = int(i);
+                ++same_arity_count;
+            }
+
+            return !argumentValidation && same_arity_count == 1 ? same_arity : index;
+        }
+
+        class ProxyHandler : public CefV8Handler
+        {
+        public:
+            ProxyHandler(const ProxyCallKind _kind, const int _class_id, const int _index)
+                :
+                CefV8Handler(),
+                kind(_kind),
+                classId(_class_id),
+                index(_index)
+            {
+            }
+
+            virtual bool Execute(const CefString& name, CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception) override
+            {
+                int handle = 0;
+
+                if(kind == PROXY_CALL_METHOD)
+                {
+                    ProxyData * data = object ? dynamic_cast<ProxyData *>(object->GetUserData().get()) : nullptr;
+
+                    if(!data)
+                    {
+                        exception = "embindcefv8: method called on a non-proxy object";
+                        return true;
+                    }
+
+                    handle = data->handle;
+                }
+
+                auto & info = getClasses()[classId];
+                auto & names = kind == PROXY_CALL_METHOD ? info.methodNames : info.staticFunctionNames;
+                auto & signatures = kind == PROXY_CALL_METHOD ? info.methodSignatures : info.staticFunctionSignatures;
+                const int target = findProxyOverload(names, signatures, index, arguments);
+
+                if(target < 0)
+                {
+                    exception = "embindcefv8: " + info.name + " belongs to an unloaded plugin";
+                    return true;
+                }
+
+                auto & argument_objects = signatures[target].objects;
+
+                WireWriter call;
+                call.writeVarUInt(kind);
+                call.writeVarUInt(uint32(handle));
+                call.writeVarUInt(uint32(classId));
+                call.writeVarUInt(uint32(target));
+                call.writeVarUInt(uint32(arguments.size()));
+
+                for(size_t i = 0; i < arguments.size(); ++i)
+                {
+                    if(!writeV8Value(call, arguments[i], i < argument_objects.size() ? argument_objects[i] : nullptr))
+                    {
+                        exception = "embindcefv8: argument cannot be sent to the browser process";
+                        return true;
+                    }
+                }
+
+                CefRefPtr<CefV8Context> current_context = CefV8Context::GetCurrentContext();
+                CefRefPtr<CefBrowser> current_browser = current_context->GetBrowser();
+                ContextRegistry * registry = getContextRegistry(current_context);
+
+                if(!registry)
+                {
+                    exception = "embindcefv8: no bindings for the current context";
+                    return true;
+                }
+
+                CefRefPtr<CefV8Value> deferred = registry->deferredFactory->ExecuteFunction(nullptr, CefV8ValueList());
+                const uint32 call_id = nextProxyCallId++;
+
+                pendingProxyCalls[call_id] = {current_context, deferred->GetValue("resolve"), deferred->GetValue("reject")};
+
+                auto & batch = proxyBatches[current_browser->GetIdentifier()];
+                batch.browser = current_browser;
+                batch.writer.writeVarUInt(call_id);
+                batch.writer.writeVarUInt(uint32(call.getSize()));
+                batch.writer.append(call);
+
+                if(!proxyFlushScheduled)
+                {
+                    proxyFlushScheduled = true;
+                    CefPostTask(TID_RENDERER, new ProxyFlushTask());
+                }
+
+                retval = deferred->GetValue("promise");
+                return true;
+            }
+
+            IMPLEMENT_REFCOUNTING(ProxyHandler);
+        private:
+            ProxyCallKind
+                kind;
+            int
+                classId;
+            int
+                index;
+        };
+
+        static CefRefPtr<CefV8Value> getProxyFunction(ContextRegistry & registry, const ProxyCallKind kind, const int class_id, const int index, const std::string & name)
+        {
+            auto key = std::make_pair(kind == PROXY_CALL_METHOD ? class_id : -1 - class_id, index);
+            auto it = registry.proxyFunctions.find(key);
+
+            if(it != registry.proxyFunctions.end())
+            {
+                return it->second;
+            }
+
+            CefRefPtr<CefV8Value> function = CefV8Value::CreateFunction(name, new ProxyHandler(kind, class_id, index));
+            registry.proxyFunctions[key] = function;
+
+            return function;
+        }
+
+        static CefRefPtr<CefV8Value> createProxyObject(const int handle, const int class_id)
+        {
+            ContextRegistry * registry = getContextRegistry(CefV8Context::GetCurrentContext());
+
+            if(!registry)
+            {
+                return CefV8Value::CreateUndefined();
+            }
+
+            auto it = registry->proxyObjects.find(handle);
+
+            if(it != registry->proxyObjects.end())
+            {
+                return it->second;
+            }
+
+            auto & classes = getClasses();
+            CefRefPtr<CefV8Value> result = CefV8Value::CreateObject(nullptr);
+
+            result->SetUserData(new ProxyData(handle, class_id));
+
+            for(int id = class_id; id >= 0 && id < int(classes.size()); id = classes[id].getBaseId())
+            {
+                auto & info = classes[id];
+
+                for(size_t i = 0; i < info.methodNames.size(); ++i)
+                {
+                    if(!result->HasValue(info.methodNames[i]))
+                    {
+                        result->SetValue(info.methodNames[i], getProxyFunction(*registry, PROXY_CALL_METHOD, id, int(i), info.methodNames[i]), V8_PROPERTY_ATTRIBUTE_READONLY);
+                    }
+                }
+            }
+
+            registry->proxyObjects[handle] = result;
+
+            return result;
+        }
+
+        void installProxies(ContextRegistry & registry)
+        {
+            CefRefPtr<CefV8Exception> exception;
+
+            registry.context->Eval(deferredFactoryCode, registry.deferredFactory, exception);
+
+            CefRefPtr<CefV8Value> remote = CefV8Value::CreateObject(nullptr);
+            auto & classes = getClasses();
+
+            for(int id = 0; id < int(classes.size()); ++id)
+            {
+                auto & info = classes[id];
+                CefRefPtr<CefV8Value> mirror = CefV8Value::CreateObject(nullptr);
+
+                for(size_t i = 0; i < info.staticFunctionNames.size(); ++i)
+                {
+                    mirror->SetValue(info.staticFunctionNames[i], getProxyFunction(registry, PROXY_CALL_STATIC_FUNCTION, id, int(i), info.staticFunctionNames[i]), V8_PROPERTY_ATTRIBUTE_NONE);
+                }
+
+                remote->SetValue(info.name, mirror, V8_PROPERTY_ATTRIBUTE_NONE);
+            }
+
+            registry.moduleObject->SetValue("remote", remote, V8_PROPERTY_ATTRIBUTE_NONE);
+
+            for(auto & global : proxyGlobals)
+            {
+                registry.moduleObject->SetValue(global.name, createProxyObject(global.handle, global.classId), V8_PROPERTY_ATTRIBUTE_NONE);
+            }
+        }
+
+        bool onProcessMessageReceived(CefRefPtr<CefBrowser> browser_, CefProcessId source_process, CefRefPtr<CefProcessMessage> message)
+        {
+            const std::string name = message->GetName().ToString();
+
+            if(name == proxyCallsMessage)
+            {
+                processProxyCalls(browser_, message->GetArgumentList()->GetBinary(0));
+                return true;
+            }
+
+            if(name == proxyRepliesMessage)
+            {
+                processProxyReplies(message->GetArgumentList()->GetBinary(0));
+                return true;
+            }
+
+            return false;
+        }
+    #endif
+
+    std::vector<std::string>
+        pendingJavaScript;
+    bool
+        javaScriptFlushScheduled = false;
+
+    #ifdef CEF
+        class JavaScriptFlushTask : public CefTask
+        {
+        public:
+            virtual void Execute() override
+            {
+                flushJavaScript();
+            }
+
+            IMPLEMENT_REFCOUNTING(JavaScriptFlushTask);
+        };
+    #else
+        static void flushJavaScriptCallback(void *)
+        {
+            flushJavaScript();
+        }
+    #endif
+
+    void executeJavaScript(const char *str)
+    {
+        #ifdef EMSCRIPTEN
+            emscripten_run_script(str);
+        #else
+            CefRefPtr<CefFrame> frame = browser->GetMainFrame();
+            frame->ExecuteJavaScript(str, frame->GetURL(), 0);
+        #endif
+    }
+
+    void queueJavaScript(const char *str)
+    {
+        #ifdef CEF
+            CefRefPtr<CefTaskRunner> task_runner = CefTaskRunner::GetForCurrentThread();
+
+            // Without a task runner nothing would ever flush the queue.
+            if(!task_runner)
+            {
+                executeJavaScript(str);
+                return;
+            }
+        #endif
+
+        pendingJavaScript.push_back(str);
+
+        if(!javaScriptFlushScheduled)
+        {
+            javaScriptFlushScheduled = true;
+
+            #ifdef EMSCRIPTEN
+                emscripten_async_call(flushJavaScriptCallback, nullptr, 0);
+            #else
+                task_runner->PostTask(new JavaScriptFlushTask());
+            #endif
+        }
+    }
+
+    // Appends text as a double-quoted JavaScript string literal.
+    static void appendJavaScriptString(std::string & output, const std::string & text)
+    {
+        static const char
+            hex[] = "0123456789abcdef";
+
+        output += '"';
+
+        for(size_t i = 0; i < text.size(); ++i)
+        {
+            const unsigned char c = text[i];
+
+            if(c == '"' || c == '\\')
+            {
+                output += '\\';
+                output += char(c);
+            }
+            else if(c < 0x20)
+            {
+                output += "\\u00";
+                output += hex[c >> 4];
+                output += hex[c & 15];
+            }
+            // U+2028 and U+2029 end a line inside string literals for older parsers.
+            else if(c == 0xe2 && i + 2 < text.size() && (unsigned char)text[i + 1] == 0x80 && ((unsigned char)text[i + 2] & 0xfe) == 0xa8)
+            {
+                output += (unsigned char)text[i + 2] == 0xa8 ? "\\u2028" : "\\u2029";
+                i += 2;
+            }
+            else
+            {
+                output += char(c);
+            }
+        }
+
+        output += '"';
+    }
+
+    void flushJavaScript()
+    {
+        javaScriptFlushScheduled = false;
+
+        if(pendingJavaScript.empty())
+        {
+            return;
+        }
+
+        std::vector<std::string> scripts;
+        scripts.swap(pendingJavaScript);
+
+        // One ExecuteJavaScript for the whole queue. Each snippet goes through a global (indirect) eval of its own,
+        // so var and function declarations stay global, and a syntax error or exception only loses that snippet;
+        // the error is rethrown from a timer to be reported as uncaught.
+        std::string source;
+
+        for(auto & script : scripts)
+        {
+            source += "try{(0,eval)(";
+            appendJavaScriptString(source, script);
+            source += ");}catch(e){setTimeout(function(){throw e;},0);}\n";
+        }
+
+        executeJavaScript(source.c_str());
+    }
+
+    #ifdef EMSCRIPTEN
+        void JavaScriptFunction::compile()
+        {
+            if(function.isUndefined())
+            {
+                function = emscripten::val::global("eval")(code);
+            }
+        }
+    #else
+        int JavaScriptFunction::nextId = 0;
+
+        bool JavaScriptFunction::enter()
+        {
+            entered = getDefaultContextRegistry();
+
+            if(!entered || !entered->context->IsValid() || !entered->context->Enter())
+            {
+                return false;
+            }
+
+            function = entered->compiledFunctions[id];
+
+            if(!function)
+            {
+                CefRefPtr<CefV8Exception> exception;
+
+                if(!entered->context->Eval(code, function, exception) || !function->IsFunction())
+                {
+                    function = nullptr;
+                    entered->compiledFunctions.erase(id);
+                    entered->context->Exit();
+                    return false;
+                }
+
+                entered->compiledFunctions[id] = function;
+            }
+
+            outerRegistry = callRegistry;
+            callRegistry = entered;
+
+            return true;
+        }
+
+        CefRefPtr<CefV8Value> JavaScriptFunction::invoke(const CefV8ValueList & arguments)
+        {
+            return function->ExecuteFunction(nullptr, arguments);
+        }
+
+        void JavaScriptFunction::exit()
+        {
+            function = nullptr;
+            callRegistry = outerRegistry;
+            entered->context->Exit();
+        }
+    #endif
 }
@@ -1,20 +1,58 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cstring>
+#include <tuple>
 #include <type_traits>
 
 #ifdef EMSCRIPTEN
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstdlib>
+    #include <optional>
     #include <emscripten.h>
     #include <emscripten/bind.h>
 #else
     #include "include/cef_client.h"
     #include "include/cef_app.h"
+    #include <algorithm>
+    #include <cstddef>
     #include <functional>
-    #include <tuple>
+    #include <map>
+    #include <memory>
+    #include <vector>
+    #include <string>
+    #include <string_view>
+    #include <typeinfo>
 #endif
 
+#if !defined(EMSCRIPTEN) && defined(__GNUC__) && !defined(_WIN32)
+    // Binding descriptors are emitted as constant data into their own section and walked at startup.
+    #ifdef __APPLE__
+        #define EMBINDCEFV8_SECTION __attribute__((used, section("__DATA,embindcefv8")))
+    #else
+        #define EMBINDCEFV8_SECTION __attribute__((used, section("embindcefv8_init")))
+    #endif
+#endif
+
+#ifdef _WIN32
+    #define EMBINDCEFV8_EXPORT __declspec(dllexport)
+#else
+    #define EMBINDCEFV8_EXPORT __attribute__((visibility("default")))
+#endif
+
+// Entry point of a binding plugin, run by Module.load("<name>").
+#define EMBINDCEFV8_PLUGIN extern "C" EMBINDCEFV8_EXPORT void embindcefv8_plugin_init()
+
 #ifdef EMSCRIPTEN
     #define EMBINDCEFV8_BINDINGS EMSCRIPTEN_BINDINGS
+#elif defined(EMBINDCEFV8_SECTION)
+    #define EMBINDCEFV8_BINDINGS(name)\
+        static void EmbindCefV8Initializer_##name();\
+        EMBINDCEFV8_SECTION static const embindcefv8::InitializerEntry EmbindCefV8Initializer_##name##_entry = { #name, &EmbindCefV8Initializer_##name };\
+        static void EmbindCefV8Initializer_##name()
 #else
     #define EMBINDCEFV8_BINDINGS(name)\
         static struct EmbindCefV8Initializer_##name {\
@@ -34,57 +72,506 @@ namespace embindcefv8
         using value = void;
     };
 
+    // Every declared base, GetBaseClass being the first; void declares none.
+    template<typename T>
+    struct GetBaseClasses
+    {
+        using value = std::tuple<>;
+    };
+
+    template<typename ... Bases>
+    struct BaseClassList
+    {
+        using value = std::tuple<Bases...>;
+    };
+
+    template<>
+    struct BaseClassList<void>
+    {
+        using value = std::tuple<>;
+    };
+
     #ifdef CEF
         using Initializer = std::function<void()>;
-        using Registerer = std::function<void(CefRefPtr<CefV8Value>&)>;
+
+        struct InitializerEntry
+        {
+            const char
+                * name;
+            void
+                (* init)();
+        };
+        struct ContextRegistry;
+
+        using Registerer = std::function<void(ContextRegistry&)>;
         using ResultFunction = std::function<void(CefRefPtr<CefV8Value>&, const CefV8ValueList&)>;
         using GetterFunction = std::function<void(CefRefPtr<CefV8Value>&, void*)>;
         using SetterFunction = std::function<void(void*, const CefRefPtr<CefV8Value>&)>;
         using MethodFunction = std::function<void(CefRefPtr<CefV8Value>&, void*, const CefV8ValueList& arguments)>;
-        using ConstructorFunction = std::function<void(void *&, const CefV8ValueList& arguments)>;
+
+        class WireWriter;
+        class WireReader;
+
+        using ProxyFunction = std::function<bool(WireWriter&, WireReader&, const int argument_count)>;
+        using ProxyMethodFunction = std::function<bool(WireWriter&, void*, WireReader&, const int argument_count)>;
+        using WireIdFunction = int (*)();
 
         std::map<std::string, Initializer> & getInitializers();
         void onContextCreated(CefV8Context* context);
+        void onContextReleased(CefV8Context* context);
         void setBrowser(CefRefPtr<CefBrowser> browser);
         bool hasContext();
         CefRefPtr<CefV8Value> & getModuleObject();
         std::vector<Registerer> & getRegisterers();
+        void installInContexts(const Registerer & registerer);
+
+        void onRenderProcessThreadCreated(CefRefPtr<CefListValue> extra_info);
+        void onRenderThreadCreated(CefRefPtr<CefListValue> extra_info);
+        bool onProcessMessageReceived(CefRefPtr<CefBrowser> browser, CefProcessId source_process, CefRefPtr<CefProcessMessage> message);
+        void ensureBindings();
+        int getProxyHandle(void * data, const int class_id);
+        // Null when the handle was removed or its object is not usable as class_id.
+        void * getProxyObject(const int handle, const int class_id);
+        void removeProxyObject(void * data, const int class_id);
+        void addProxyGlobal(const char * name, const int handle, const int class_id);
+
+        // What the renderer needs to pick a proxy overload and write its arguments.
+        struct ProxySignature
+        {
+            // Accepted JavaScript kinds of each argument, see ArgumentKinds.
+            const unsigned char
+                * kinds;
+            // Value object each argument expects (see wireObjectOf()), so plain objects are written positionally.
+            std::vector<WireIdFunction>
+                objects;
+
+            bool isSameAs(const ProxySignature & other) const
+            {
+                return objects.size() == other.objects.size() && std::equal(kinds, kinds + objects.size(), other.kinds);
+            }
+        };
+
+        struct ClassInfo
+        {
+            std::string
+                name;
+            int
+                (* getBaseId)();
+            std::vector<std::string>
+                methodNames;
+            std::vector<ProxyMethodFunction>
+                methods;
+            // Proxy entries may share a name as overloads, told apart by their signature.
+            std::vector<ProxySignature>
+                methodSignatures;
+            std::vector<std::string>
+                staticFunctionNames;
+            std::vector<ProxyFunction>
+                staticFunctions;
+            std::vector<ProxySignature>
+                staticFunctionSignatures;
+            CefRefPtr<CefV8Value>
+                (* createConstructor)(ContextRegistry &);
+            void
+                (* createMethods)(ContextRegistry &);
+            const std::type_info
+                * type;
+            void
+                (* wrap)(CefRefPtr<CefV8Value> &, const void *);
+            // From a pointer to the base class to this class, null when the object is not one.
+            const void
+                * (* downcast)(const void *);
+            // Declared bases with the offset of each inside this class, and every ancestor flattened on first use.
+            std::vector<std::pair<int (*)(), std::ptrdiff_t>>
+                bases;
+            std::vector<std::pair<int, std::ptrdiff_t>>
+                ancestors;
+            bool
+                ancestorsReady;
+        };
+
+        std::vector<ClassInfo> & getClasses();
+        // Bumped whenever a property is registered in any class, so flattened slot tables including bases are rebuilt.
+        unsigned & getPropertyGeneration();
+        int findClass(const std::string & name);
+
+        // Wraps object, whose static class is class_id, as its most-derived registered class; false if that is class_id itself.
+        bool wrapMostDerived(CefRefPtr<CefV8Value>& retval, const void * object, const void * complete_object, const std::type_info & type, const int class_id);
+
+        // Everything that holds V8 handles lives here, one instance per V8 context.
+        struct ContextRegistry
+        {
+            CefRefPtr<CefV8Context>
+                context;
+            CefRefPtr<CefV8Value>
+                moduleObject;
+            std::vector<CefRefPtr<CefV8Value>>
+                constructors;
+            std::vector<std::map<std::string, CefRefPtr<CefV8Value>>>
+                methods;
+            std::vector<bool>
+                methodsReady;
+            std::map<int, CefRefPtr<CefV8Value>>
+                compiledFunctions;
+            CefRefPtr<CefV8Value>
+                deferredFactory;
+            std::map<std::pair<int, int>, CefRefPtr<CefV8Value>>
+                proxyFunctions;
+            std::map<int, CefRefPtr<CefV8Value>>
+                proxyObjects;
+            CefRefPtr<CefV8Value>
+                typeErrorFunction;
+            CefRefPtr<CefV8Value>
+                undefinedValue,
+                nullValue,
+                trueValue,
+                falseValue;
+            std::vector<CefRefPtr<CefV8Value>>
+                integerValues;
+        };
 
-        class FuncHandler : public CefV8Handler
+        ContextRegistry * getContextRegistry();
+        ContextRegistry * getContextRegistry(CefRefPtr<CefV8Context> context);
+        // The entered context's registry, otherwise the main frame's, otherwise the oldest one.
+        ContextRegistry * getDefaultContextRegistry();
+
+        // Primitive results are shared per context; integers in [minimum, maximum] are cached as they are returned.
+        void setIntegerCacheRange(const int minimum, const int maximum);
+        CefRefPtr<CefV8Value> createInt(const int value);
+        CefRefPtr<CefV8Value> createUInt(const unsigned value);
+        CefRefPtr<CefV8Value> createBool(const bool value);
+        CefRefPtr<CefV8Value> createUndefined();
+        CefRefPtr<CefV8Value> createNull();
+
+        // Bump allocator for argument temporaries; each native call rewinds it to where it started.
+        class ScratchArena
         {
         public:
-            FuncHandler(ResultFunction & _func) : CefV8Handler()
+            struct Mark
+            {
+                size_t
+                    block,
+                    offset,
+                    destructorCount;
+            };
+
+            ScratchArena() = default;
+            ScratchArena(const ScratchArena &) = delete;
+            ~ScratchArena();
+
+            void * allocate(const size_t size, const size_t alignment = alignof(std::max_align_t));
+            void trim(void * last, const size_t size);
+            Mark mark() const;
+            void rewind(const Mark & mark);
+
+            // True while a ScratchScope is open, i.e. something will rewind what is allocated now.
+            bool inScope() const
             {
-                func = _func;
+                return scopes != 0;
             }
 
-            virtual bool Execute(const CefString& name, CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception) override
+            template<typename T, typename ... Args>
+            T * create(Args && ... args)
             {
-                func(retval, arguments);
-                return true;
+                T * object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args) ...);
+
+                if(!std::is_trivially_destructible_v<T>)
+                {
+                    destructors.push_back({object, [](void * o) { static_cast<T *>(o)->~T(); }});
+                }
+
+                return object;
             }
 
-            IMPLEMENT_REFCOUNTING(FuncHandler);
         private:
+            friend struct ScratchScope;
+
+            struct Block
+            {
+                std::unique_ptr<char[]>
+                    data;
+                size_t
+                    size;
+            };
+
+            struct Destructor
+            {
+                void
+                    * object;
+                void
+                    (* destroy)(void *);
+            };
+
+            std::vector<Block>
+                blocks;
+            std::vector<Destructor>
+                destructors;
+            size_t
+                current = 0,
+                offset = 0,
+                scopes = 0;
+        };
+
+        ScratchArena & getScratchArena();
+
+        struct ScratchScope
+        {
+            ScratchScope()
+                :
+                mark(getScratchArena().mark())
+            {
+                ++getScratchArena().scopes;
+            }
+
+            ~ScratchScope()
+            {
+                ScratchArena
+                    & arena = getScratchArena();
+
+                --arena.scopes;
+                arena.rewind(mark);
+            }
+
+            ScratchArena::Mark
+                mark;
+        };
+
+        // Storage for a by-reference temporary: the scratch arena inside a native call, otherwise a per-thread slot reused by the next conversion.
+        template<typename T>
+        T & scratchValue()
+        {
+            ScratchArena
+                & arena = getScratchArena();
+
+            assert(arena.inScope() && "references to converted values are only valid inside a native call");
+
+            if(!arena.inScope())
+            {
+                thread_local T
+                    owned;
+
+                owned = T();
+
+                return owned;
+            }
+
+            return * arena.create<T>();
+        }
+
+        // UTF-8 <-> UTF-16 transcoding for strings crossing the boundary, with a SIMD path for ASCII runs.
+        std::string toUtf8(const CefString & value);
+        const char * toUtf8(const CefString & value, ScratchArena & arena, size_t * size = nullptr);
+        CefString toCefString(const char * data, const size_t length);
+
+        inline CefString toCefString(const std::string & value)
+        {
+            return toCefString(value.data(), value.size());
+        }
+
+        inline CefString toCefString(const char * value)
+        {
+            return toCefString(value, strlen(value));
+        }
+
+        struct ValueObjectField
+        {
+            std::string
+                name;
+            std::function<bool(WireWriter&, const void*)>
+                pack;
+            std::function<void(WireReader&, void*)>
+                unpack;
+            std::function<bool(CefListValue&, int, const void*)>
+                toList;
+            std::function<void(CefListValue&, int, void*)>
+                fromList;
+            // Lets the renderer write a nested value object in field order, see wireObjectOf().
+            WireIdFunction
+                objectId;
+        };
+
+        struct ValueObjectInfo
+        {
+            std::string
+                name;
+            std::vector<ValueObjectField>
+                fields;
+        };
+
+        std::vector<ValueObjectInfo> & getValueObjects();
+
+        // Fields of these types are read and written straight from their offset, without a closure.
+        enum class FieldType
+        {
+            Other,
+            Bool,
+            Int,
+            Unsigned,
+            Float,
+            Double,
+            String
+        };
+
+        template<typename F> constexpr FieldType fieldTypeOf = FieldType::Other;
+        template<> constexpr FieldType fieldTypeOf<bool> = FieldType::Bool;
+        template<> constexpr FieldType fieldTypeOf<int> = FieldType::Int;
+        template<> constexpr FieldType fieldTypeOf<unsigned int> = FieldType::Unsigned;
+        template<> constexpr FieldType fieldTypeOf<float> = FieldType::Float;
+        template<> constexpr FieldType fieldTypeOf<double> = FieldType::Double;
+        template<> constexpr FieldType fieldTypeOf<std::string> = FieldType::String;
+
+        struct ClassProperty
+        {
+            FieldType
+                type;
+            size_t
+                offset;
+            // Only set for FieldType::Other: non primitive fields and getter/setter pairs.
+            GetterFunction
+                get;
+            SetterFunction
+                set;
+            bool
+                (* accepts)(const CefRefPtr<CefV8Value> &);
+            bool
+                writable,
+                // Copied once into a plain data property when the object is wrapped.
+                constant;
+        };
+
+        // Flattened property table of a class and its bases, in the order used by __read and __snapshot.
+        struct PropertySlot
+        {
+            std::string
+                name;
+            const ClassProperty
+                * property;
+            // From the object of the class listing the slot to the object of the class declaring it.
+            std::ptrdiff_t
+                offset;
+        };
+
+        void readProperty(const ClassProperty & property, void * object, CefRefPtr<CefV8Value>& retval);
+        bool writeProperty(const ClassProperty & property, void * object, const CefRefPtr<CefV8Value>& value);
+
+        // offsetof needs the member's name, which a pointer to member does not carry. The offset is taken from
+        // the address of the field in aligned storage instead: nothing is read or constructed there, and no null
+        // pointer is dereferenced.
+        template<class T, class F>
+        size_t getFieldOffset(F (T::*field))
+        {
+            static std::aligned_storage_t<sizeof(T), alignof(T)>
+                storage;
+            const char * bytes = reinterpret_cast<const char *>(&storage);
+            const T * base = reinterpret_cast<const T *>(bytes);
+
+            return size_t(reinterpret_cast<const char *>(&(base->*field)) - bytes);
+        }
+
+        enum class BindingKind
+        {
+            Constructor,
+            Function,
+            Method
+        };
+
+        // One entry per exposed constructor, function and method, in registration order.
+        using OverloadMatcher = bool (*)(const CefV8ValueList & arguments);
+
+        // JavaScript types an argument accepts, one bit each; a signature stores one mask per parameter.
+        enum ArgumentKind : unsigned char
+        {
+            ARGUMENT_NUMBER = 1,
+            ARGUMENT_BOOL = 2,
+            ARGUMENT_STRING = 4,
+            ARGUMENT_OBJECT = 8
+        };
+
+        using ClassIdFunction = int (*)();
+
+        // One signature of a binding; an arity of -1 accepts any argument count.
+        struct BindingOverload
+        {
+            int
+                arity;
+            OverloadMatcher
+                matches;
+            const unsigned char
+                * kinds;
+            // Per parameter, the id of the bound class it expects, or null for any other type.
+            const ClassIdFunction
+                * classes;
+            ResultFunction
+                function;
+            MethodFunction
+                method;
+        };
+
+        struct Binding
+        {
+            BindingKind
+                kind;
+            int
+                classId;
+            std::string
+                name;
             ResultFunction
-                func;
+                function;
+            MethodFunction
+                method;
+            CefRefPtr<CefV8Handler>
+                handler;
+            std::vector<BindingOverload>
+                overloads;
         };
 
+        std::vector<Binding> & getBindings();
+        int addBinding(const Binding & binding);
+        void addOverload(const int id, const BindingOverload & overload);
+
+        // Type checks run before every call unless disabled; argument counts and bound class arguments are always checked.
+        void setArgumentValidation(const bool enabled);
+        // Raises a TypeError in the JavaScript calling the current binding.
+        void throwTypeError(const std::string & message);
+        // Returns false when the call was rejected; the error is then pending in JavaScript or set in exception.
+        bool invokeBinding(const int id, const CefRefPtr<CefV8Value> & object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception);
+        // Calls method binding id on every element of objects; the overload is picked and checked once for the shared arguments.
+        void invokeOnArray(const int id, const CefRefPtr<CefV8Value> & objects, const CefV8ValueList& arguments, const bool collect, CefRefPtr<CefV8Value>& retval);
+        CefRefPtr<CefV8Value> createBindingFunction(const int id);
+        void registerExtension();
+        bool isExtensionClass(const int class_id);
+        bool isExtensionBinding(const int binding_id);
+
+        // Plugins are shared libraries whose EMBINDCEFV8_PLUGIN body registers their bindings.
+        void setPluginDirectory(const char * directory);
+        // Lets pages load and unload this plugin; Module.load only exists once a plugin is allowed.
+        void allowPlugin(const char * name);
+        bool loadPlugin(const std::string & name, std::string & error);
+        bool unloadPlugin(const std::string & name, std::string & error);
+        void loadExtensionMethods(ContextRegistry & registry, const int class_id);
+
         template<typename T>
         struct IsValueObject
         {
             static constexpr bool value = false;
         };
 
+        // Set by EMBINDCEFV8_DECLARE_STRING: such classes convert from JavaScript strings.
+        template<typename T>
+        struct IsStringClass
+        {
+            static constexpr bool value = false;
+        };
+
         struct UserData : public CefBase
         {
-            UserData(void * _data)
-                : data(_data)
+            UserData(void * _data, const int class_id = -1)
+                : data(_data), classId(class_id)
             {
             }
 
-            UserData(const void * _data)
-                : data(const_cast<void*>(_data))
+            UserData(const void * _data, const int class_id = -1)
+                : data(const_cast<void*>(_data)), classId(class_id)
             {
             }
 
@@ -94,29 +581,58 @@ namespace embindcefv8
 
             void
                 * data;
+            // Class data points to, used to adjust the pointer when a base class is requested.
+            int
+                classId;
 
             IMPLEMENT_REFCOUNTING(UserData);
         };
 
-        class MethodHandler : public CefV8Handler
+        // Null unless base_id is class_id or one of its registered ancestors.
+        void * upcastObject(void * object, const int class_id, const int base_id);
+
+        inline void * getObject(const UserData & data, const int class_id)
         {
-        public:
-            MethodHandler(MethodFunction & _method) : CefV8Handler()
-            {
-                method = _method;
-            }
+            return data.classId == class_id ? data.data : upcastObject(data.data, data.classId, class_id);
+        }
+
+        // Whether value wraps an object usable as class_id.
+        bool isInstanceOf(const CefRefPtr<CefV8Value> & value, const int class_id);
+
+        // Downcasting from a virtual or ambiguous base is ill-formed, which rules both out.
+        template<typename Derived, typename Base, class Enable = void>
+        struct IsNonVirtualBase : std::false_type
+        {
+        };
+
+        template<typename Derived, typename Base>
+        struct IsNonVirtualBase<Derived, Base, std::void_t<decltype(static_cast<Derived *>(std::declval<Base *>()))>> : std::is_base_of<Base, Derived>
+        {
+        };
+
+        // Offset of Base inside Derived. A standard-layout class shares its address with every base subobject,
+        // so that offset is 0 without casting anything. Other classes give no such guarantee (a vtable pointer or
+        // a second base moves the subobject) and the offset comes from a static_cast on aligned storage, which is
+        // only address arithmetic for non-virtual bases: nothing is read and no null pointer is involved.
+        template<typename Derived, typename Base>
+        std::ptrdiff_t getUpcastOffset()
+        {
+            static_assert(IsNonVirtualBase<Derived, Base>::value, "bases expects non-virtual, unambiguous base classes");
 
-            virtual bool Execute(const CefString& name, CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception) override
+            if constexpr(std::is_standard_layout_v<Derived>)
             {
-                method(retval, dynamic_cast<UserData*>(object->GetUserData().get())->data, arguments);
-                return true;
+                return 0;
             }
+            else
+            {
+                static std::aligned_storage_t<sizeof(Derived), alignof(Derived)>
+                    storage;
+                unsigned char * bytes = reinterpret_cast<unsigned char *>(&storage);
+                Derived * derived = reinterpret_cast<Derived *>(bytes);
 
-            IMPLEMENT_REFCOUNTING(FuncHandler);
-        private:
-            MethodFunction
-                method;
-        };
+                return reinterpret_cast<unsigned char *>(static_cast<Base *>(derived)) - bytes;
+            }
+        }
 
         template<typename T>
         class Class;
@@ -124,6 +640,9 @@ namespace embindcefv8
         template<typename T>
         class ClassAccessor;
 
+        template<typename V>
+        struct ValueObjectView;
+
         template<typename T>
         struct ValueCreator;
 
@@ -141,7 +660,7 @@ namespace embindcefv8
         {
             static void create(CefRefPtr<CefV8Value>& retval, const int value)
             {
-                retval = CefV8Value::CreateInt(value);
+                retval = createInt(value);
             }
         };
 
@@ -150,7 +669,7 @@ namespace embindcefv8
         {
             static void create(CefRefPtr<CefV8Value>& retval, const unsigned value)
             {
-                retval = CefV8Value::CreateUInt(value);
+                retval = createUInt(value);
             }
         };
 
@@ -159,7 +678,7 @@ namespace embindcefv8
         {
             static void create(CefRefPtr<CefV8Value>& retval, const unsigned char value)
             {
-                retval = CefV8Value::CreateUInt(value);
+                retval = createUInt(value);
             }
         };
 
@@ -168,7 +687,7 @@ namespace embindcefv8
         {
             static void create(CefRefPtr<CefV8Value>& retval, const bool value)
             {
-                retval = CefV8Value::CreateBool(value);
+                retval = createBool(value);
             }
         };
 
@@ -177,7 +696,7 @@ namespace embindcefv8
         {
             static void create(CefRefPtr<CefV8Value>& retval, const std::string & value)
             {
-                retval = CefV8Value::CreateString(value);
+                retval = CefV8Value::CreateString(toCefString(value));
             }
         };
 
@@ -198,7 +717,7 @@ namespace embindcefv8
             {
                 if(value == nullptr)
                 {
-                    retval = CefV8Value::CreateUndefined();
+                    retval = createUndefined();
                     return;
                 }
 
@@ -210,6 +729,63 @@ namespace embindcefv8
         template<class T>
         class ValueObject;
 
+        template<typename T>
+        struct ClassId
+        {
+            static int get()
+            {
+                return Class<T>::id;
+            }
+        };
+
+        template<>
+        struct ClassId<void>
+        {
+            static int get()
+            {
+                return -1;
+            }
+        };
+
+        // Parameters of these types, by value, reference or pointer, must be wrapped instances of their class.
+        template<typename T>
+        constexpr bool IsBoundClass = std::is_class_v<T> && !IsValueObject<T>::value && !IsStringClass<T>::value && !std::is_same_v<T, std::string> && !std::is_same_v<T, std::string_view>;
+
+        // Strings converted to these types point into the scratch arena and do not outlive the native call.
+        template<typename T>
+        constexpr bool IsScratchString = std::is_same_v<std::decay_t<T>, const char *> || std::is_same_v<std::decay_t<T>, std::string_view>;
+
+        template<typename F>
+        constexpr ClassIdFunction argumentClassOf()
+        {
+            using Type = std::remove_cv_t<std::remove_pointer_t<std::remove_cv_t<std::remove_reference_t<F>>>>;
+
+            if constexpr(IsBoundClass<Type>)
+            {
+                return &ClassId<Type>::get;
+            }
+            else
+            {
+                return nullptr;
+            }
+        }
+
+        template<typename ... Args>
+        struct ArgumentClasses
+        {
+            static constexpr ClassIdFunction
+                value[sizeof...(Args) + 1] = { argumentClassOf<Args>() ..., nullptr };
+        };
+
+        // Wrapped object of a bound class, or null when v does not wrap one usable as Type.
+        template<typename Type>
+        Type * getWrappedObject(CefV8Value & v)
+        {
+            UserData * data = dynamic_cast<UserData*>(v.GetUserData().get());
+
+            return data ? static_cast<Type *>(getObject(*data, Class<std::remove_const_t<Type>>::id)) : nullptr;
+        }
+
         template<typename T, class Enable = void>
         struct ValueConverter
         {
@@ -220,7 +796,7 @@ namespace embindcefv8
             std::enable_if_t<!IsValueObject<Type>::value, Q>
             get(CefV8Value & v)
             {
-                return * reinterpret_cast<T *>(dynamic_cast<UserData*>(v.GetUserData().get())->data);
+                return * getWrappedObject<Type>(v);
             }
 
             template<class Q = Type>
@@ -233,7 +809,7 @@ namespace embindcefv8
 
                 for(auto& kv : ValueObject<T>::setters)
                 {
-                    kv.second((void*) &result, v.GetValue(kv.first));
+                    kv.second((void*) &result, v.IsObject() ? v.GetValue(kv.first) : createUndefined());
                 }
 
                 return result;
@@ -247,7 +823,7 @@ namespace embindcefv8
             {
                 using type = std::remove_pointer_t<T>;
 
-                return reinterpret_cast<type *>(dynamic_cast<UserData*>(v.GetUserData().get())->data);
+                return getWrappedObject<type>(v);
             }
         };
 
@@ -261,21 +837,20 @@ namespace embindcefv8
             std::enable_if_t<!IsValueObject<Type>::value, Q>
             get(CefV8Value & v)
             {
-                using Type2 = std::remove_reference_t<T>;
-                return *reinterpret_cast<Type2 *>(dynamic_cast<UserData*>(v.GetUserData().get())->data);
+                return * getWrappedObject<std::remove_reference_t<T>>(v);
             }
 
-            template<class Q = Type>
+            template<class Q = T>
             static
             std::enable_if_t<IsValueObject<Type>::value, Q>
             get(CefV8Value & v)
             {
                 Type
-                    result;
+                    & result = scratchValue<Type>();
 
                 for(auto& kv : ValueObject<Type>::setters)
                 {
-                    kv.second((void*) &result, v.GetValue(kv.first));
+                    kv.second((void*) &result, v.IsObject() ? v.GetValue(kv.first) : createUndefined());
                 }
 
                 return result;
@@ -292,8 +867,7 @@ namespace embindcefv8
             std::enable_if_t<!IsValueObject<Type>::value, Q>
             get(CefV8Value & v)
             {
-                using Type2 = std::remove_reference_t<T>;
-                return *reinterpret_cast<Type2 *>(dynamic_cast<UserData*>(v.GetUserData().get())->data);
+                return * getWrappedObject<std::remove_reference_t<T>>(v);
             }
 
             template<class Q = T>
@@ -302,11 +876,11 @@ namespace embindcefv8
             get(CefV8Value & v)
             {
                 Type
-                    & result = * new Type();
+                    & result = scratchValue<Type>();
 
                 for(auto& kv : ValueObject<Type>::setters)
                 {
-                    kv.second((void*) &result, v.GetValue(kv.first));
+                    kv.second((void*) &result, v.IsObject() ? v.GetValue(kv.first) : createUndefined());
                 }
 
                 return result;
@@ -358,12 +932,39 @@ namespace embindcefv8
             }
         };
 
+        template<>
+        struct ValueConverter<std::string_view>
+        {
+            static std::string_view get(CefV8Value & v)
+            {
+                ScratchArena
+                    & arena = getScratchArena();
+
+                assert(arena.inScope() && "string views are only valid as arguments of a native call");
+
+                if(!arena.inScope())
+                {
+                    thread_local std::string
+                        owned;
+
+                    owned = toUtf8(v.GetStringValue());
+
+                    return owned;
+                }
+
+                size_t size;
+                const char * data = toUtf8(v.GetStringValue(), arena, &size);
+
+                return std::string_view(data, size);
+            }
+        };
+
         template<>
         struct ValueConverter<const char *>
         {
             static const char * get(CefV8Value & v)
             {
-                return v.GetStringValue().ToString().c_str();
+                return ValueConverter<std::string_view>::get(v).data();
             }
         };
 
@@ -372,588 +973,2952 @@ namespace embindcefv8
         {
             static std::string get(CefV8Value & v)
             {
-                return v.GetStringValue().ToString();
+                return toUtf8(v.GetStringValue());
             }
         };
 
-        template<typename Result, typename ... Args>
-        struct FunctionInvoker
+        // Whether a JavaScript value can be assigned to a property of type F.
+        template<typename F>
+        bool acceptsValue(const CefRefPtr<CefV8Value> & value)
         {
-            template<int N>
-            using GetArgType = std::tuple_element_t<N, std::tuple<Args...>>;
+            using Type = std::remove_cv_t<std::remove_reference_t<F>>;
 
-            static void call(Result (*staticFunction)(Args...), CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            if constexpr(std::is_same_v<Type, bool>)
             {
-                  internalCall(staticFunction, std::index_sequence_for<Args...>{}, retval, arguments);
+                return value->IsBool();
             }
-
-         private:
-            template<class Function, std::size_t... Is>
-            static void internalCall(Function func, std::index_sequence<Is...>, CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            else if constexpr(std::is_arithmetic_v<Type> || std::is_enum_v<Type>)
             {
-                const Result & r = (*func)((ValueConverter<GetArgType<Is>>::get(*arguments[Is])) ...);
-                ValueCreatorCaller<Result>::create(retval, r);
+                return value->IsDouble();
             }
-        };
-
-        template<typename T, typename Result, typename ... Args>
-        struct MethodInvoker
-        {
-            template<int N>
-            using GetArgType = std::tuple_element_t<N, std::tuple<Args...>>;
-
-            static void call(Result (T::*field)(Args...), void * object, CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            else if constexpr(std::is_same_v<Type, std::string> || std::is_same_v<Type, std::string_view> || std::is_same_v<Type, const char *> || IsStringClass<Type>::value)
             {
-                internalCall(field, object, std::index_sequence_for<Args...>{}, retval, arguments);
+                return value->IsString();
             }
-
-            static void call(Result (T::*field)(Args...) const, void * object, CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            else if constexpr(argumentClassOf<F>() != nullptr)
             {
-                internalCall(field, object, std::index_sequence_for<Args...>{}, retval, arguments);
+                return isInstanceOf(value, argumentClassOf<F>()());
             }
-
-            static void call(Result (T::*field)(Args...), void * object, const CefV8ValueList& arguments)
+            else
             {
-                internalCall(field, object, std::index_sequence_for<Args...>{}, arguments);
+                return value->IsObject();
             }
+        }
 
-            static void call(Result (T::*field)(Args...) const, void * object, const CefV8ValueList& arguments)
-            {
-                internalCall(field, object, std::index_sequence_for<Args...>{}, arguments);
-            }
+        // Overloads are told apart by arity, then by these cheap checks; integers only match integral parameters.
+        template<typename F>
+        bool matchesArgument(const CefRefPtr<CefV8Value> & value)
+        {
+            using Type = std::remove_cv_t<std::remove_reference_t<F>>;
 
-        private:
-            template<class Field, std::size_t... Is>
-            static void internalCall(Field field, void * object, std::index_sequence<Is...>, const CefV8ValueList& arguments)
+            if constexpr(std::is_integral_v<Type> && !std::is_same_v<Type, bool>)
             {
-                ((*(T *) object).*field)((ValueConverter<GetArgType<Is>>::get(*arguments[Is])) ...);
+                return value->IsInt() || value->IsUInt();
             }
-
-            template<class Field, std::size_t... Is>
-            static void internalCall(Field field, void * object, std::index_sequence<Is...>, CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            else
             {
-                const Result & r = ((*(T *) object).*field)((ValueConverter<GetArgType<Is>>::get(*arguments[Is])) ...);
-                ValueCreatorCaller<Result>::create(retval, r);
+                return acceptsValue<F>(value);
             }
-        };
+        }
 
-        template<typename T, typename ... Args>
-        struct ConstructorInvoker
+        template<typename ... Args, std::size_t ... Is>
+        bool matchesArgumentList(const CefV8ValueList & arguments, std::index_sequence<Is...>)
         {
-            template<int N>
-            using GetArgType = typename std::tuple_element_t<N, std::tuple<Args...>>;
+            return (matchesArgument<Args>(arguments[Is]) && ...);
+        }
 
-            static T * call(const CefV8ValueList& arguments)
+        template<typename ... Args>
+        bool matchesArguments(const CefV8ValueList & arguments)
+        {
+            return arguments.size() == sizeof...(Args) && matchesArgumentList<Args...>(arguments, std::index_sequence_for<Args...>{});
+        }
+
+        template<typename F>
+        constexpr unsigned char argumentKindOf()
+        {
+            using Type = std::remove_cv_t<std::remove_reference_t<F>>;
+
+            if constexpr(std::is_same_v<Type, bool>)
+            {
+                return ARGUMENT_BOOL;
+            }
+            else if constexpr(std::is_arithmetic_v<Type> || std::is_enum_v<Type>)
+            {
+                return ARGUMENT_NUMBER;
+            }
+            else if constexpr(std::is_same_v<Type, std::string> || std::is_same_v<Type, std::string_view> || std::is_same_v<Type, const char *> || IsStringClass<Type>::value)
+            {
+                return ARGUMENT_STRING;
+            }
+            else
+            {
+                return ARGUMENT_OBJECT;
+            }
+        }
+
+        template<typename ... Args>
+        struct ArgumentKinds
+        {
+            static constexpr unsigned char
+                value[sizeof...(Args) + 1] = { argumentKindOf<Args>() ..., 0 };
+        };
+
+        enum class WireTag : unsigned char
+        {
+            Undefined,
+            Bool,
+            Int,
+            Double,
+            String,
+            Handle,
+            Object,
+            Array,
+            UInt
+        };
+
+        class WireWriter
+        {
+        public:
+            void writeVarUInt(uint32 value)
+            {
+                while(value >= 0x80)
+                {
+                    buffer.push_back(char(value | 0x80));
+                    value >>= 7;
+                }
+
+                buffer.push_back(char(value));
+            }
+
+            void writeUndefined()
+            {
+                writeTag(WireTag::Undefined);
+            }
+
+            void writeBool(const bool value)
+            {
+                writeTag(WireTag::Bool);
+                buffer.push_back(value ? 1 : 0);
+            }
+
+            void writeInt(const int value)
+            {
+                writeTag(WireTag::Int);
+                writeVarUInt((uint32(value) << 1) ^ uint32(value >> 31));
+            }
+
+            void writeUInt(const uint32 value)
+            {
+                writeTag(WireTag::UInt);
+                writeVarUInt(value);
+            }
+
+            void writeDouble(const double value)
+            {
+                writeTag(WireTag::Double);
+                buffer.append(reinterpret_cast<const char *>(&value), sizeof(double));
+            }
+
+            void writeString(const char * data, const size_t length)
+            {
+                writeTag(WireTag::String);
+                writeVarUInt(uint32(length));
+                buffer.append(data, length);
+            }
+
+            void writeString(const std::string & value)
+            {
+                writeString(value.data(), value.size());
+            }
+
+            void writeHandle(const int handle, const int class_id)
+            {
+                writeTag(WireTag::Handle);
+                writeVarUInt(uint32(handle));
+                writeVarUInt(uint32(class_id));
+            }
+
+            // Value objects are written as their registered id followed by the fields in declaration order.
+            void writeObjectHeader(const int type_id, const size_t field_count)
+            {
+                writeTag(WireTag::Object);
+                writeVarUInt(uint32(type_id));
+                writeVarUInt(uint32(field_count));
+            }
+
+            void writeArrayHeader(const size_t count)
+            {
+                writeTag(WireTag::Array);
+                writeVarUInt(uint32(count));
+            }
+
+            const char * getData() const
+            {
+                return buffer.data();
+            }
+
+            size_t getSize() const
+            {
+                return buffer.size();
+            }
+
+            void clear()
+            {
+                buffer.clear();
+            }
+
+            void append(const WireWriter & other)
+            {
+                buffer.append(other.buffer);
+            }
+
+        private:
+            void writeTag(const WireTag tag)
+            {
+                buffer.push_back(char(tag));
+            }
+
+            std::string
+                buffer;
+        };
+
+        class WireReader
+        {
+        public:
+            WireReader(const void * data, const size_t size)
+                :
+                current(static_cast<const unsigned char *>(data)),
+                end(static_cast<const unsigned char *>(data) + size),
+                valid(true),
+                depth(0)
+            {
+            }
+
+            // Readers recurse once per nested Object or Array; deeper payloads fail instead of exhausting the stack.
+            static constexpr int
+                maxDepth = 64;
+
+            // Counts one nesting level for its lifetime.
+            class Nesting
+            {
+            public:
+                Nesting(WireReader & _reader)
+                    :
+                    reader(_reader)
+                {
+                    if(++reader.depth > maxDepth)
+                    {
+                        reader.fail();
+                    }
+                }
+
+                ~Nesting()
+                {
+                    --reader.depth;
+                }
+
+            private:
+                WireReader
+                    & reader;
+            };
+
+            bool isValid() const
+            {
+                return valid;
+            }
+
+            bool atEnd() const
+            {
+                return current >= end;
+            }
+
+            void fail()
+            {
+                valid = false;
+                current = end;
+            }
+
+            const unsigned char * getPosition() const
+            {
+                return current;
+            }
+
+            size_t getRemaining() const
+            {
+                return size_t(end - current);
+            }
+
+            void skipBytes(const size_t count)
+            {
+                current += std::min(count, getRemaining());
+            }
+
+            WireTag peekTag() const
+            {
+                return atEnd() ? WireTag::Undefined : WireTag(*current);
+            }
+
+            uint32 readVarUInt()
+            {
+                uint32
+                    result = 0;
+                int
+                    shift = 0;
+
+                while(current < end && shift < 35)
+                {
+                    const unsigned char byte = *current++;
+                    result |= uint32(byte & 0x7f) << shift;
+
+                    if(!(byte & 0x80))
+                    {
+                        return result;
+                    }
+
+                    shift += 7;
+                }
+
+                fail();
+                return 0;
+            }
+
+            bool readBool()
+            {
+                switch(readTag())
+                {
+                    case WireTag::Bool: return readByte() != 0;
+                    case WireTag::Int: return readZigZag() != 0;
+                    case WireTag::UInt: return readVarUInt() != 0;
+                    case WireTag::Double: return readRawDouble() != 0.0;
+                    case WireTag::Undefined: return false;
+                    default: fail(); return false;
+                }
+            }
+
+            int readInt()
+            {
+                switch(readTag())
+                {
+                    case WireTag::Int: return readZigZag();
+                    case WireTag::UInt: return int(readVarUInt());
+                    case WireTag::Double: return int(readRawDouble());
+                    case WireTag::Bool: return readByte();
+                    default: fail(); return 0;
+                }
+            }
+
+            uint32 readUInt()
+            {
+                switch(readTag())
+                {
+                    case WireTag::UInt: return readVarUInt();
+                    case WireTag::Int: return uint32(readZigZag());
+                    case WireTag::Double: return uint32(readRawDouble());
+                    case WireTag::Bool: return uint32(readByte());
+                    default: fail(); return 0;
+                }
+            }
+
+            double readDouble()
+            {
+                switch(readTag())
+                {
+                    case WireTag::Double: return readRawDouble();
+                    case WireTag::Int: return readZigZag();
+                    case WireTag::UInt: return readVarUInt();
+                    default: fail(); return 0.0;
+                }
+            }
+
+            std::string readString()
+            {
+                if(readTag() != WireTag::String)
+                {
+                    fail();
+                    return std::string();
+                }
+
+                const uint32 length = readVarUInt();
+
+                if(uint32(end - current) < length)
+                {
+                    fail();
+                    return std::string();
+                }
+
+                std::string result(reinterpret_cast<const char *>(current), length);
+                current += length;
+
+                return result;
+            }
+
+            bool readRawHandle(int & handle, int & class_id)
+            {
+                if(readTag() != WireTag::Handle)
+                {
+                    fail();
+                    return false;
+                }
+
+                handle = int(readVarUInt());
+                class_id = int(readVarUInt());
+
+                return valid;
+            }
+
+            bool readObjectHeader(int & type_id, uint32 & field_count)
+            {
+                if(readTag() != WireTag::Object)
+                {
+                    fail();
+                    return false;
+                }
+
+                type_id = int(readVarUInt());
+                field_count = readVarUInt();
+
+                return valid;
+            }
+
+            bool readArrayHeader(uint32 & count)
+            {
+                if(readTag() != WireTag::Array)
+                {
+                    fail();
+                    return false;
+                }
+
+                count = readVarUInt();
+
+                return valid;
+            }
+
+            void * readHandle(const int expected_class_id)
+            {
+                int
+                    handle,
+                    class_id;
+
+                if(!readRawHandle(handle, class_id))
+                {
+                    return nullptr;
+                }
+
+                void * object = getProxyObject(handle, expected_class_id);
+
+                if(!object)
+                {
+                    fail();
+                }
+
+                return object;
+            }
+
+            void skipValue()
+            {
+                switch(readTag())
+                {
+                    case WireTag::Undefined: break;
+                    case WireTag::Bool: readByte(); break;
+                    case WireTag::Int: readVarUInt(); break;
+                    case WireTag::UInt: readVarUInt(); break;
+                    case WireTag::Double: readRawDouble(); break;
+                    case WireTag::String: skipBytes(readVarUInt()); break;
+                    case WireTag::Handle: readVarUInt(); readVarUInt(); break;
+                    case WireTag::Object: readVarUInt(); skipNested(readVarUInt()); break;
+                    case WireTag::Array: skipNested(readVarUInt()); break;
+                    default: fail(); break;
+                }
+            }
+
+            void skipValues(const uint32 count)
+            {
+                for(uint32 i = 0; i < count && valid; ++i)
+                {
+                    skipValue();
+                }
+            }
+
+        private:
+            void skipNested(const uint32 count)
+            {
+                Nesting nesting(*this);
+
+                skipValues(count);
+            }
+
+            WireTag readTag()
+            {
+                return WireTag(readByte());
+            }
+
+            int readByte()
+            {
+                if(current >= end)
+                {
+                    fail();
+                    return 0;
+                }
+
+                return *current++;
+            }
+
+            int readZigZag()
+            {
+                const uint32 value = readVarUInt();
+                return int((value >> 1) ^ (~(value & 1) + 1));
+            }
+
+            double readRawDouble()
+            {
+                double
+                    result = 0.0;
+
+                if(size_t(end - current) < sizeof(double))
+                {
+                    fail();
+                    return result;
+                }
+
+                memcpy(&result, current, sizeof(double));
+                current += sizeof(double);
+
+                return result;
+            }
+
+            const unsigned char
+                * current,
+                * end;
+            bool
+                valid;
+            int
+                depth;
+        };
+
+        template<typename T>
+        struct IsWireContainer
+        {
+            static constexpr bool value = false;
+        };
+
+        template<typename T>
+        struct IsWireContainer<std::vector<T>>
+        {
+            static constexpr bool value = true;
+        };
+
+        // Bound classes cross the wire as proxy handles; everything else is copied by value.
+        template<typename T>
+        constexpr bool IsWireHandle = std::is_class_v<T> && !IsValueObject<T>::value && !std::is_same_v<T, std::string> && !IsWireContainer<T>::value;
+
+        // Wire id of the value object an argument or field carries, directly or as vector items; null for anything else.
+        template<typename F>
+        constexpr WireIdFunction wireObjectOf()
+        {
+            using Type = std::remove_cv_t<std::remove_reference_t<F>>;
+
+            if constexpr(IsValueObject<Type>::value)
+            {
+                return &ValueObject<Type>::getWireId;
+            }
+            else if constexpr(IsWireContainer<Type>::value)
+            {
+                return wireObjectOf<typename Type::value_type>();
+            }
+            else
+            {
+                return nullptr;
+            }
+        }
+
+        template<typename ... Args>
+        struct ArgumentWireObjects
+        {
+            static constexpr WireIdFunction
+                value[sizeof...(Args) + 1] = { wireObjectOf<Args>() ..., nullptr };
+        };
+
+        template<typename T, class Enable = void>
+        struct WireCodec
+        {
+            using Stored = T *;
+
+            static bool write(WireWriter & writer, const T & value)
+            {
+                // A bound class returned by value has no stable address to hand out as a proxy handle.
+                return false;
+            }
+
+            static Stored read(WireReader & reader)
+            {
+                return static_cast<T *>(reader.readHandle(ClassId<T>::get()));
+            }
+
+            static T & get(Stored & stored)
+            {
+                return *stored;
+            }
+
+            static bool writeHandle(WireWriter & writer, const T & value)
+            {
+                const int class_id = ClassId<T>::get();
+
+                if(class_id < 0)
+                {
+                    return false;
+                }
+
+                writer.writeHandle(getProxyHandle(const_cast<T *>(&value), class_id), class_id);
+                return true;
+            }
+        };
+
+        template<typename T>
+        struct WireCodec<T, std::enable_if_t<IsValueObject<T>::value>>
+        {
+            using Stored = T;
+
+            static bool write(WireWriter & writer, const T & value)
+            {
+                return ValueObject<T>::pack(writer, & value);
+            }
+
+            static Stored read(WireReader & reader)
+            {
+                T
+                    result {};
+
+                ValueObject<T>::unpack(reader, & result);
+
+                return result;
+            }
+
+            static T & get(Stored & stored)
+            {
+                return stored;
+            }
+        };
+
+        template<typename T>
+        struct WireCodec<std::vector<T>>
+        {
+            using Stored = std::vector<T>;
+
+            static bool write(WireWriter & writer, const std::vector<T> & value)
+            {
+                writer.writeArrayHeader(value.size());
+
+                for(auto & item : value)
+                {
+                    if(!WireCodec<T>::write(writer, item))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            static Stored read(WireReader & reader)
+            {
+                Stored
+                    result;
+                uint32
+                    count;
+                WireReader::Nesting nesting(reader);
+
+                if(reader.isValid() && reader.readArrayHeader(count))
+                {
+                    result.reserve(std::min<size_t>(count, reader.getRemaining()));
+
+                    for(uint32 i = 0; i < count && reader.isValid(); ++i)
+                    {
+                        auto item = WireCodec<T>::read(reader);
+
+                        if(reader.isValid())
+                        {
+                            result.push_back(WireCodec<T>::get(item));
+                        }
+                    }
+                }
+
+                return result;
+            }
+
+            static std::vector<T> & get(Stored & stored)
+            {
+                return stored;
+            }
+        };
+
+        template<typename T>
+        struct WireCodec<T, std::enable_if_t<std::is_pointer_v<T>>>
+        {
+            using Type = std::remove_const_t<std::remove_pointer_t<T>>;
+            using Stored = Type *;
+
+            static bool write(WireWriter & writer, const T & value)
+            {
+                if(value == nullptr)
+                {
+                    writer.writeUndefined();
+                    return true;
+                }
+
+                return WireCodec<Type>::writeHandle(writer, *value);
+            }
+
+            static Stored read(WireReader & reader)
+            {
+                if(reader.peekTag() == WireTag::Undefined)
+                {
+                    reader.skipValue();
+                    return nullptr;
+                }
+
+                return static_cast<Type *>(reader.readHandle(ClassId<std::remove_const_t<Type>>::get()));
+            }
+
+            static T get(Stored & stored)
+            {
+                return stored;
+            }
+        };
+
+        template<typename T>
+        struct WireCodec<T, std::enable_if_t<std::is_reference_v<T>>>
+        {
+            using Type = std::remove_const_t<std::remove_reference_t<T>>;
+            using Base = WireCodec<Type>;
+            using Stored = typename Base::Stored;
+
+            template<class Q = Type>
+            static
+            std::enable_if_t<IsWireHandle<Q>, bool>
+            write(WireWriter & writer, const Type & value)
+            {
+                return Base::writeHandle(writer, value);
+            }
+
+            template<class Q = Type>
+            static
+            std::enable_if_t<!IsWireHandle<Q>, bool>
+            write(WireWriter & writer, const Type & value)
+            {
+                return Base::write(writer, value);
+            }
+
+            static Stored read(WireReader & reader)
+            {
+                return Base::read(reader);
+            }
+
+            static T get(Stored & stored)
+            {
+                return Base::get(stored);
+            }
+        };
+
+        template<typename T>
+        struct WirePrimitiveCodec
+        {
+            using Stored = T;
+
+            static T & get(Stored & stored)
+            {
+                return stored;
+            }
+        };
+
+        template<>
+        struct WireCodec<int> : WirePrimitiveCodec<int>
+        {
+            static bool write(WireWriter & writer, const int value) { writer.writeInt(value); return true; }
+            static int read(WireReader & reader) { return reader.readInt(); }
+        };
+
+        template<>
+        struct WireCodec<unsigned> : WirePrimitiveCodec<unsigned>
+        {
+            static bool write(WireWriter & writer, const unsigned value) { writer.writeUInt(value); return true; }
+            static unsigned read(WireReader & reader) { return reader.readUInt(); }
+        };
+
+        template<>
+        struct WireCodec<unsigned char> : WirePrimitiveCodec<unsigned char>
+        {
+            static bool write(WireWriter & writer, const unsigned char value) { writer.writeInt(value); return true; }
+            static unsigned char read(WireReader & reader) { return (unsigned char)reader.readInt(); }
+        };
+
+        template<>
+        struct WireCodec<bool> : WirePrimitiveCodec<bool>
+        {
+            static bool write(WireWriter & writer, const bool value) { writer.writeBool(value); return true; }
+            static bool read(WireReader & reader) { return reader.readBool(); }
+        };
+
+        template<>
+        struct WireCodec<float> : WirePrimitiveCodec<float>
+        {
+            static bool write(WireWriter & writer, const float value) { writer.writeDouble(value); return true; }
+            static float read(WireReader & reader) { return float(reader.readDouble()); }
+        };
+
+        template<>
+        struct WireCodec<double> : WirePrimitiveCodec<double>
+        {
+            static bool write(WireWriter & writer, const double value) { writer.writeDouble(value); return true; }
+            static double read(WireReader & reader) { return reader.readDouble(); }
+        };
+
+        template<>
+        struct WireCodec<std::string> : WirePrimitiveCodec<std::string>
+        {
+            static bool write(WireWriter & writer, const std::string & value) { writer.writeString(value); return true; }
+            static std::string read(WireReader & reader) { return reader.readString(); }
+        };
+
+        template<>
+        struct WireCodec<const char *>
+        {
+            using Stored = std::string;
+
+            static bool write(WireWriter & writer, const char * value) { writer.writeString(value, strlen(value)); return true; }
+            static std::string read(WireReader & reader) { return reader.readString(); }
+            static const char * get(Stored & stored) { return stored.c_str(); }
+        };
+
+        double getListNumber(CefListValue & list, const int index);
+
+        template<typename T, class Enable = void>
+        struct ListCodec
+        {
+            static bool write(CefListValue & list, const int index, const T & value)
+            {
+                return false;
+            }
+
+            static bool read(CefListValue & list, const int index, T & value)
+            {
+                return false;
+            }
+        };
+
+        template<typename T>
+        struct ListCodec<T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>>
+        {
+            static bool write(CefListValue & list, const int index, const T & value)
+            {
+                if constexpr(std::is_same_v<T, bool>)
+                {
+                    return list.SetBool(index, value);
+                }
+                else if constexpr(std::is_floating_point_v<T>)
+                {
+                    return list.SetDouble(index, value);
+                }
+                else
+                {
+                    const long long number = (long long)value;
+
+                    if(number == (long long)int(number))
+                    {
+                        return list.SetInt(index, int(number));
+                    }
+
+                    return list.SetDouble(index, double(number));
+                }
+            }
+
+            static bool read(CefListValue & list, const int index, T & value)
+            {
+                if constexpr(std::is_floating_point_v<T> || std::is_same_v<T, bool>)
+                {
+                    value = T(getListNumber(list, index));
+                }
+                else
+                {
+                    value = (T)(long long)getListNumber(list, index);
+                }
+
+                return true;
+            }
+        };
+
+        template<>
+        struct ListCodec<std::string>
+        {
+            static bool write(CefListValue & list, const int index, const std::string & value)
+            {
+                return list.SetString(index, value);
+            }
+
+            static bool read(CefListValue & list, const int index, std::string & value)
+            {
+                if(list.GetType(index) != VTYPE_STRING)
+                {
+                    return false;
+                }
+
+                value = list.GetString(index).ToString();
+                return true;
+            }
+        };
+
+        template<typename T>
+        struct ListCodec<T, std::enable_if_t<IsValueObject<T>::value>>
+        {
+            static bool write(CefListValue & list, const int index, const T & value)
+            {
+                CefRefPtr<CefListValue> fields = CefListValue::Create();
+
+                return ValueObject<T>::toList(*fields, & value) && list.SetList(index, fields);
+            }
+
+            static bool read(CefListValue & list, const int index, T & value)
+            {
+                if(list.GetType(index) != VTYPE_LIST)
+                {
+                    return false;
+                }
+
+                ValueObject<T>::fromList(*list.GetList(index), & value);
+                return true;
+            }
+        };
+
+        template<typename T>
+        struct ListCodec<std::vector<T>>
+        {
+            static bool write(CefListValue & list, const int index, const std::vector<T> & value)
+            {
+                CefRefPtr<CefListValue> items = CefListValue::Create();
+                items->SetSize(value.size());
+
+                for(size_t i = 0; i < value.size(); ++i)
+                {
+                    if(!ListCodec<T>::write(*items, int(i), value[i]))
+                    {
+                        return false;
+                    }
+                }
+
+                return list.SetList(index, items);
+            }
+
+            static bool read(CefListValue & list, const int index, std::vector<T> & value)
+            {
+                if(list.GetType(index) != VTYPE_LIST)
+                {
+                    return false;
+                }
+
+                CefRefPtr<CefListValue> items = list.GetList(index);
+                value.resize(items->GetSize());
+
+                for(size_t i = 0; i < value.size(); ++i)
+                {
+                    if(!ListCodec<T>::read(*items, int(i), value[i]))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        };
+
+        template<typename Result>
+        struct ProxyResultWriter
+        {
+            template<class Call>
+            static bool write(WireWriter & writer, Call && call)
+            {
+                const Result & r = call();
+                return WireCodec<Result>::write(writer, r);
+            }
+        };
+
+        template<>
+        struct ProxyResultWriter<void>
+        {
+            template<class Call>
+            static bool write(WireWriter & writer, Call && call)
+            {
+                call();
+                writer.writeUndefined();
+                return true;
+            }
+        };
+
+        template<typename Result, typename ... Args>
+        struct ProxyFunctionInvoker
+        {
+            using StoredArgs = std::tuple<typename WireCodec<Args>::Stored ...>;
+
+            static bool call(Result (*staticFunction)(Args...), WireWriter & writer, WireReader & reader, const int argument_count)
+            {
+                if(argument_count < int(sizeof...(Args)))
+                {
+                    return false;
+                }
+
+                // Braced initialization guarantees the arguments are decoded left to right.
+                StoredArgs stored { WireCodec<Args>::read(reader) ... };
+
+                // Extra arguments are ignored, as JavaScript does.
+                reader.skipValues(uint32(argument_count - int(sizeof...(Args))));
+
+                if(!reader.isValid())
+                {
+                    return false;
+                }
+
+                return internalCall(staticFunction, std::index_sequence_for<Args...>{}, stored, writer);
+            }
+
+        private:
+            template<class Function, std::size_t... Is>
+            static bool internalCall(Function func, std::index_sequence<Is...>, StoredArgs & stored, WireWriter & writer)
+            {
+                return ProxyResultWriter<Result>::write(writer, [&]() -> Result {
+                    return (*func)(WireCodec<Args>::get(std::get<Is>(stored)) ...);
+                });
+            }
+        };
+
+        template<typename T, typename Result, typename ... Args>
+        struct ProxyMethodInvoker
+        {
+            using StoredArgs = std::tuple<typename WireCodec<Args>::Stored ...>;
+
+            template<class Field>
+            static bool call(Field field, void * object, WireWriter & writer, WireReader & reader, const int argument_count)
+            {
+                if(argument_count < int(sizeof...(Args)))
+                {
+                    return false;
+                }
+
+                StoredArgs stored { WireCodec<Args>::read(reader) ... };
+
+                reader.skipValues(uint32(argument_count - int(sizeof...(Args))));
+
+                if(!reader.isValid())
+                {
+                    return false;
+                }
+
+                return internalCall(field, object, std::index_sequence_for<Args...>{}, stored, writer);
+            }
+
+        private:
+            template<class Field, std::size_t... Is>
+            static bool internalCall(Field field, void * object, std::index_sequence<Is...>, StoredArgs & stored, WireWriter & writer)
+            {
+                return ProxyResultWriter<Result>::write(writer, [&]() -> Result {
+                    return ((*(T *) object).*field)(WireCodec<Args>::get(std::get<Is>(stored)) ...);
+                });
+            }
+        };
+
+        template<typename Result, typename ... Args>
+        struct FunctionInvoker
+        {
+            template<int N>
+            using GetArgType = std::tuple_element_t<N, std::tuple<Args...>>;
+
+            static void call(Result (*staticFunction)(Args...), CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            {
+                  internalCall(staticFunction, std::index_sequence_for<Args...>{}, retval, arguments);
+            }
+
+         private:
+            template<class Function, std::size_t... Is>
+            static void internalCall(Function func, std::index_sequence<Is...>, CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            {
+                const Result & r = (*func)((ValueConverter<GetArgType<Is>>::get(*arguments[Is])) ...);
+                ValueCreatorCaller<Result>::create(retval, r);
+            }
+        };
+
+        template<typename T, typename Result, typename ... Args>
+        struct MethodInvoker
+        {
+            template<int N>
+            using GetArgType = std::tuple_element_t<N, std::tuple<Args...>>;
+
+            static void call(Result (T::*field)(Args...), void * object, CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            {
+                internalCall(field, object, std::index_sequence_for<Args...>{}, retval, arguments);
+            }
+
+            static void call(Result (T::*field)(Args...) const, void * object, CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            {
+                internalCall(field, object, std::index_sequence_for<Args...>{}, retval, arguments);
+            }
+
+            static void call(Result (T::*field)(Args...), void * object, const CefV8ValueList& arguments)
+            {
+                internalCall(field, object, std::index_sequence_for<Args...>{}, arguments);
+            }
+
+            static void call(Result (T::*field)(Args...) const, void * object, const CefV8ValueList& arguments)
+            {
+                internalCall(field, object, std::index_sequence_for<Args...>{}, arguments);
+            }
+
+        private:
+            template<class Field, std::size_t... Is>
+            static void internalCall(Field field, void * object, std::index_sequence<Is...>, const CefV8ValueList& arguments)
+            {
+                ((*(T *) object).*field)((ValueConverter<GetArgType<Is>>::get(*arguments[Is])) ...);
+            }
+
+            template<class Field, std::size_t... Is>
+            static void internalCall(Field field, void * object, std::index_sequence<Is...>, CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            {
+                const Result & r = ((*(T *) object).*field)((ValueConverter<GetArgType<Is>>::get(*arguments[Is])) ...);
+                ValueCreatorCaller<Result>::create(retval, r);
+            }
+        };
+
+        template<typename T, typename ... Args>
+        struct ConstructorInvoker
+        {
+            template<int N>
+            using GetArgType = typename std::tuple_element_t<N, std::tuple<Args...>>;
+
+            static T * call(const CefV8ValueList& arguments)
+            {
+                return internalCall(std::index_sequence_for<Args...>{}, arguments);
+            }
+
+        private:
+            template<std::size_t... Is>
+            static T * internalCall(std::index_sequence<Is...>, const CefV8ValueList& arguments)
+            {
+                return new T((ValueConverter<GetArgType<Is>>::get(*arguments[Is])) ...);
+            }
+        };
+    #endif
+
+    template<class T>
+    class ValueObject
+    {
+    public:
+        ValueObject(const char *_name)
+        {
+            name = _name;
+
+            #ifdef EMSCRIPTEN
+                emVo = new emscripten::value_object<T>(_name);
+            #else
+                if(wireId < 0)
+                {
+                    wireId = int(getValueObjects().size());
+                    getValueObjects().push_back({name, {}});
+                }
+            #endif
+        }
+
+        ~ValueObject()
+        {
+            #ifdef EMSCRIPTEN
+                delete emVo;
+            #else
+                if(constructors.size())
+                {
+                    auto copied_name = name;
+                    int binding = addBinding({BindingKind::Function, -1, name, nullptr, nullptr, nullptr, {}});
+
+                    for(auto & overload : constructors)
+                    {
+                        addOverload(binding, overload);
+                    }
+
+                    getRegisterers().push_back(
+                        [copied_name, binding](ContextRegistry & registry)
+                        {
+                            if(isExtensionBinding(binding))
+                            {
+                                return;
+                            }
+
+                            registry.moduleObject->SetValue(copied_name.c_str(), createBindingFunction(binding), V8_PROPERTY_ATTRIBUTE_NONE);
+                        }
+                    );
+                }
+            #endif
+        }
+
+        template<typename ... Args>
+        ValueObject & constructor()
+        {
+            #ifdef EMSCRIPTEN
+                T ( * func )(Args && ... args) =
+                    [](Args && ... args) -> T
+                    {
+                        return T(std::forward<Args&&>( args )...);
+                    };
+
+                emscripten::function(name.c_str(), func);
+            #else
+                // Values are copied into a plain object, so the constructed instance is only temporary.
+                constructors.push_back({int(sizeof...(Args)), &matchesArguments<Args...>, ArgumentKinds<Args...>::value, ArgumentClasses<Args...>::value, [](CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments) {
+                    std::unique_ptr<T> new_object(ConstructorInvoker<T, Args...>::call(arguments));
+
+                    ValueCreator<T>::create(retval, * new_object);
+                }, nullptr});
+            #endif
+
+            return *this;
+        }
+
+        template<class F>
+        ValueObject & property(const char *name, F (T::*field))
+        {
+            #ifdef EMSCRIPTEN
+                emVo->field(name, field);
+            #else
+                getters[name] = [field](CefRefPtr<CefV8Value>& retval, void * object) {
+                    ValueCreatorCaller<F>::create(retval, (*(T *)object).*field);
+                };
+                setters[name] = [field](void * object, const CefRefPtr<CefV8Value>& cef_value) {
+                    if constexpr(argumentClassOf<F>() != nullptr)
+                    {
+                        if(!isInstanceOf(cef_value, argumentClassOf<F>()()))
+                        {
+                            return;
+                        }
+                    }
+
+                    (*(T *)object).*field = ValueConverter<F>::get(*cef_value);
+                };
+
+                if constexpr(IsValueObject<F>::value)
+                {
+                    views[name] = [field](CefRefPtr<CefV8Value>& retval, void * object) {
+                        ValueObjectView<F>::create(retval, &((*(T *)object).*field));
+                    };
+                }
+
+                ValueObjectField wire_field {
+                    name,
+                    [field](WireWriter & writer, const void * object) {
+                        return WireCodec<F>::write(writer, (*(const T *)object).*field);
+                    },
+                    [field](WireReader & reader, void * object) {
+                        auto stored = WireCodec<F>::read(reader);
+
+                        if(reader.isValid())
+                        {
+                            (*(T *)object).*field = WireCodec<F>::get(stored);
+                        }
+                    },
+                    [field](CefListValue & list, const int index, const void * object) {
+                        return ListCodec<F>::write(list, index, (*(const T *)object).*field);
+                    },
+                    [field](CefListValue & list, const int index, void * object) {
+                        ListCodec<F>::read(list, index, (*(T *)object).*field);
+                    },
+                    wireObjectOf<F>()
+                };
+
+                auto & fields = getValueObjects()[wireId].fields;
+                auto it = std::find_if(fields.begin(), fields.end(), [name](const ValueObjectField & f) { return f.name == name; });
+
+                if(it != fields.end())
+                {
+                    *it = wire_field;
+                }
+                else
+                {
+                    fields.push_back(wire_field);
+                }
+            #endif
+
+            return *this;
+        }
+
+        #ifdef CEF
+            static int getWireId()
+            {
+                return wireId;
+            }
+
+            static bool pack(WireWriter & writer, const T * object)
+            {
+                auto & fields = getValueObjects()[wireId].fields;
+
+                writer.writeObjectHeader(wireId, fields.size());
+
+                for(auto & field : fields)
+                {
+                    if(!field.pack(writer, object))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            static void unpack(WireReader & reader, T * object)
+            {
+                auto & fields = getValueObjects()[wireId].fields;
+                int type_id;
+                uint32 count;
+                WireReader::Nesting nesting(reader);
+
+                if(!reader.isValid() || !reader.readObjectHeader(type_id, count) || type_id != wireId)
+                {
+                    reader.fail();
+                    return;
+                }
+
+                for(uint32 i = 0; i < count && reader.isValid(); ++i)
+                {
+                    // Fields missing from a JavaScript object arrive as undefined and keep their default.
+                    if(i < fields.size() && reader.peekTag() != WireTag::Undefined)
+                    {
+                        fields[i].unpack(reader, object);
+                    }
+                    else
+                    {
+                        reader.skipValue();
+                    }
+                }
+            }
+
+            static bool toList(CefListValue & list, const T * object)
+            {
+                auto & fields = getValueObjects()[wireId].fields;
+
+                list.SetSize(fields.size());
+
+                for(size_t i = 0; i < fields.size(); ++i)
+                {
+                    if(!fields[i].toList(list, int(i), object))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            static void fromList(CefListValue & list, T * object)
+            {
+                auto & fields = getValueObjects()[wireId].fields;
+
+                for(size_t i = 0; i < fields.size() && i < list.GetSize(); ++i)
+                {
+                    fields[i].fromList(list, int(i), object);
+                }
+            }
+        #endif
+
+        template<typename C>
+        friend class ValueCreator;
+
+        template<typename C, class>
+        friend class ValueConverter;
+
+        #ifdef CEF
+            template<typename C>
+            friend struct ValueObjectView;
+        #endif
+
+    private:
+        static std::string
+            name;
+        #ifdef EMSCRIPTEN
+            emscripten::value_object<T>
+                * emVo;
+        #else
+            static std::map<std::string, GetterFunction>
+                getters;
+            static std::map<std::string, SetterFunction>
+                setters;
+            // Nested value object fields, read through a view when the parent is itself a view.
+            static std::map<std::string, GetterFunction>
+                views;
+            static std::vector<BindingOverload>
+                constructors;
+            static int
+                wireId;
+        #endif
+    };
+
+    template<class T>
+    class Class
+    {
+    public:
+
+        #ifdef EMSCRIPTEN
+        using EmscriptenBaseClass = std::conditional_t<std::is_void_v<typename GetBaseClass<T>::value>, emscripten::internal::NoBaseClass, emscripten::base<typename GetBaseClass<T>::value>>;
+        #endif
+
+        Class() = delete;
+
+        Class(const char *_name)
+        {
+            name = _name;
+
+            #ifdef EMSCRIPTEN
+                emClass = new emscripten::class_<T, EmscriptenBaseClass>(_name);
+            #else
+                if(id < 0)
+                {
+                    ClassInfo info {};
+
+                    info.name = name;
+                    info.getBaseId = &ClassId<typename GetBaseClass<T>::value>::get;
+                    info.createConstructor = &createConstructor;
+                    info.createMethods = &createMethods;
+                    info.type = &typeid(T);
+                    info.wrap = &wrap;
+                    info.downcast = getDowncast();
+                    info.bases = getBaseOffsets(static_cast<typename GetBaseClasses<T>::value *>(nullptr));
+
+                    id = int(getClasses().size());
+                    getClasses().push_back(info);
+                    constructorBinding = addBinding({BindingKind::Constructor, id, name, nullptr, nullptr, nullptr, {}});
+                    addMethod("__read", &readProperties);
+                    addMethod("__snapshot", &snapshotProperties);
+                    addMethod("__assign", &assignProperties);
+                    addFunction("__invokeAll", &invokeAll);
+                    addFunction("__map", &mapAll);
+                }
+            #endif
+        }
+
+        ~Class()
+        {
+            #ifdef EMSCRIPTEN
+                if(emClass)
+                    delete emClass;
+            #endif
+        }
+
+        template<typename ... Args>
+        Class & constructor()
+        {
+            #ifdef EMSCRIPTEN
+                emClass->template constructor<Args...>();
+            #else
+                addOverload(constructorBinding, {int(sizeof...(Args)), &matchesArguments<Args...>, ArgumentKinds<Args...>::value, ArgumentClasses<Args...>::value, [](CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments) {
+                    ValueCreator<T>::create(retval, * ConstructorInvoker<T, Args...>::call(arguments));
+                }, nullptr});
+            #endif
+
+            return *this;
+        }
+
+        template<class F>
+        Class & property(const char *name, F (T::*field))
+        {
+            #ifdef EMSCRIPTEN
+                emClass->property(name, field);
+            #else
+                registerProperty(name, field, true);
+            #endif
+
+            return *this;
+        }
+
+        // Getter/setter pairs are dispatched by the instance accessor, without a method function object.
+        template<typename G>
+        Class & property(const char *name, G (T::*getter)() const)
+        {
+            #ifdef EMSCRIPTEN
+                emClass->property(name, getter);
+            #else
+                registerAccessorProperty(name, getter);
+            #endif
+
+            return *this;
+        }
+
+        template<typename G>
+        Class & property(const char *name, G (T::*getter)())
+        {
+            #ifdef EMSCRIPTEN
+                emClass->property(name, getter);
+            #else
+                registerAccessorProperty(name, getter);
+            #endif
+
+            return *this;
+        }
+
+        template<typename G, typename S>
+        Class & property(const char *name, G (T::*getter)() const, void (T::*setter)(S))
+        {
+            #ifdef EMSCRIPTEN
+                emClass->property(name, getter, setter);
+            #else
+                registerAccessorProperty(name, getter, setter);
+            #endif
+
+            return *this;
+        }
+
+        template<typename G, typename S>
+        Class & property(const char *name, G (T::*getter)(), void (T::*setter)(S))
+        {
+            #ifdef EMSCRIPTEN
+                emClass->property(name, getter, setter);
+            #else
+                registerAccessorProperty(name, getter, setter);
+            #endif
+
+            return *this;
+        }
+
+        // Value object member exposed as a live view: o.member.field reads and writes the embedded struct in place.
+        template<class F>
+        Class & view_property(const char *name, F (T::*field))
+        {
+            #ifdef EMSCRIPTEN
+                emClass->property(name, field);
+            #else
+                static_assert(IsValueObject<F>::value, "view_property expects a value object member");
+
+                registerProperty(name, field, true);
+                properties[name].get = [field](CefRefPtr<CefV8Value>& retval, void * object) {
+                    ValueObjectView<F>::create(retval, &((*(T *)object).*field));
+                };
+            #endif
+
+            return *this;
+        }
+
+        // For members that never change after construction: read once when the object is wrapped.
+        template<class F>
+        Class & constant_property(const char *name, F (T::*field))
+        {
+            #ifdef EMSCRIPTEN
+                emClass->property(name, field);
+            #else
+                registerProperty(name, field, false);
+                properties[name].constant = true;
+            #endif
+
+            return *this;
+        }
+
+        template<typename G>
+        Class & constant_property(const char *name, G (T::*getter)() const)
+        {
+            #ifdef EMSCRIPTEN
+                emClass->property(name, getter);
+            #else
+                registerAccessorProperty(name, getter);
+                properties[name].constant = true;
+            #endif
+
+            return *this;
+        }
+
+        // Assignments from JavaScript are ignored, as they were before properties became writable.
+        template<class F>
+        Class & readonly_property(const char *name, F (T::*field))
+        {
+            #ifdef EMSCRIPTEN
+                emClass->property(name, field);
+            #else
+                registerProperty(name, field, false);
+            #endif
+
+            return *this;
+        }
+
+        // Objects returned as T are wrapped as their most-derived registered class; embind already does this.
+        Class & polymorphic()
+        {
+            #ifdef CEF
+                static_assert(std::is_polymorphic_v<T>, "polymorphic expects a class with virtual functions");
+
+                isPolymorphic = true;
+            #endif
+
+            return *this;
+        }
+
+        template<typename Result, typename ... Args>
+        Class & method(const char *name, Result (T::*field)(Args...))
+        {
+            #ifdef EMSCRIPTEN
+                emClass->function(name, field, emscripten::allow_raw_pointers());
+            #else
+                registerProxyMethod(name, [field](WireWriter & writer, void * object, WireReader & reader, const int argument_count) {
+                    return ProxyMethodInvoker<T, Result, Args...>::call(field, object, writer, reader, argument_count);
+                }, sizeof...(Args), ArgumentKinds<Args...>::value, ArgumentWireObjects<Args...>::value);
+
+                registerMethod(name, [field](CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments) {
+                    MethodInvoker<T, Result, Args...>::call(field, object, retval, arguments);
+                }, sizeof...(Args), &matchesArguments<Args...>, ArgumentKinds<Args...>::value, ArgumentClasses<Args...>::value);
+            #endif
+
+            return *this;
+        }
+
+        template<typename Result, typename ... Args>
+        Class & method(const char *name, Result (T::*field)(Args...) const)
+        {
+            #ifdef EMSCRIPTEN
+                emClass->function(name, field, emscripten::allow_raw_pointers());
+            #else
+                registerProxyMethod(name, [field](WireWriter & writer, void * object, WireReader & reader, const int argument_count) {
+                    return ProxyMethodInvoker<T, Result, Args...>::call(field, object, writer, reader, argument_count);
+                }, sizeof...(Args), ArgumentKinds<Args...>::value, ArgumentWireObjects<Args...>::value);
+
+                registerMethod(name, [field](CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments) {
+                    MethodInvoker<T, Result, Args...>::call(field, object, retval, arguments);
+                }, sizeof...(Args), &matchesArguments<Args...>, ArgumentKinds<Args...>::value, ArgumentClasses<Args...>::value);
+            #endif
+
+            return *this;
+        }
+
+        template<typename ... Args>
+        Class & method(const char *name, void (T::*field)(Args...))
+        {
+            #ifdef EMSCRIPTEN
+                emClass->function(name, field, emscripten::allow_raw_pointers());
+            #else
+                registerProxyMethod(name, [field](WireWriter & writer, void * object, WireReader & reader, const int argument_count) {
+                    return ProxyMethodInvoker<T, void, Args...>::call(field, object, writer, reader, argument_count);
+                }, sizeof...(Args), ArgumentKinds<Args...>::value, ArgumentWireObjects<Args...>::value);
+
+                registerMethod(name, [field](CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments) {
+                    MethodInvoker<T, void, Args...>::call(field, object, arguments);
+                }, sizeof...(Args), &matchesArguments<Args...>, ArgumentKinds<Args...>::value, ArgumentClasses<Args...>::value);
+            #endif
+
+            return *this;
+        }
+
+        template<typename ... Args>
+        Class & method(const char *name, void (T::*field)(Args...) const)
+        {
+            #ifdef EMSCRIPTEN
+                emClass->function(name, field, emscripten::allow_raw_pointers());
+            #else
+                registerProxyMethod(name, [field](WireWriter & writer, void * object, WireReader & reader, const int argument_count) {
+                    return ProxyMethodInvoker<T, void, Args...>::call(field, object, writer, reader, argument_count);
+                }, sizeof...(Args), ArgumentKinds<Args...>::value, ArgumentWireObjects<Args...>::value);
+
+                registerMethod(name, [field](CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments) {
+                    MethodInvoker<T, void, Args...>::call(field, object, arguments);
+                }, sizeof...(Args), &matchesArguments<Args...>, ArgumentKinds<Args...>::value, ArgumentClasses<Args...>::value);
+            #endif
+
+            return *this;
+        }
+
+        template<typename Result, typename ... Args>
+        Class & static_function(const char *name, Result (*staticFunction)(Args...))
+        {
+            #ifdef EMSCRIPTEN
+                emClass->class_function(name, staticFunction, emscripten::allow_raw_pointers());
+            #else
+                registerProxyFunction(name, [staticFunction](WireWriter & writer, WireReader & reader, const int argument_count) {
+                    return ProxyFunctionInvoker<Result, Args...>::call(staticFunction, writer, reader, argument_count);
+                }, sizeof...(Args), ArgumentKinds<Args...>::value, ArgumentWireObjects<Args...>::value);
+
+                registerFunction(name, [staticFunction](CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments) {
+                    FunctionInvoker<Result, Args...>::call(staticFunction, retval, arguments);
+                }, sizeof...(Args), &matchesArguments<Args...>, ArgumentKinds<Args...>::value, ArgumentClasses<Args...>::value);
+            #endif
+
+            return *this;
+        }
+
+        template<typename C>
+        friend class ValueCreator;
+        template<typename C>
+        friend class ClassAccessor;
+
+    //private:
+        #ifdef CEF
+            template<class F>
+            static void registerProperty(const char *name, F (T::*field), const bool writable)
+            {
+                using Type = std::remove_const_t<F>;
+
+                ClassProperty property { fieldTypeOf<Type>, getFieldOffset(field), nullptr, nullptr, &acceptsValue<F>, writable && !std::is_const_v<F>, false };
+
+                if(property.type == FieldType::Other)
+                {
+                    property.get = [field](CefRefPtr<CefV8Value>& retval, void * object) {
+                        ValueCreatorCaller<F>::create(retval, (*(T *)object).*field);
+                    };
+
+                    if constexpr(!std::is_const_v<F> && std::is_copy_assignable_v<F> && !IsScratchString<F>)
+                    {
+                        property.set = [field](void * object, const CefRefPtr<CefV8Value>& value) {
+                            (*(T *)object).*field = ValueConverter<F>::get(*value);
+                        };
+                    }
+                    else
+                    {
+                        property.writable = false;
+                    }
+                }
+
+                properties[name] = property;
+                memberIndexComplete = false;
+                ++getPropertyGeneration();
+            }
+
+            template<class Getter>
+            static void registerAccessorProperty(const char *name, Getter getter)
+            {
+                using Type = std::decay_t<decltype((std::declval<T &>().*getter)())>;
+
+                ClassProperty property { FieldType::Other, 0, nullptr, nullptr, &acceptsValue<Type>, false, false };
+
+                property.get = [getter](CefRefPtr<CefV8Value>& retval, void * object) {
+                    ValueCreatorCaller<Type>::create(retval, ((*(T *)object).*getter)());
+                };
+
+                properties[name] = property;
+                memberIndexComplete = false;
+                ++getPropertyGeneration();
+            }
+
+            template<class Getter, class S>
+            static void registerAccessorProperty(const char *name, Getter getter, void (T::*setter)(S))
+            {
+                registerAccessorProperty(name, getter);
+
+                auto & property = properties[name];
+
+                property.accepts = &acceptsValue<S>;
+                property.writable = true;
+                property.set = [setter](void * object, const CefRefPtr<CefV8Value>& value) {
+                    ((*(T *)object).*setter)(ValueConverter<S>::get(*value));
+                };
+            }
+
+            static void setMemberIndex(const char * const * names, const int count)
+            {
+                memberNames.assign(names, names + count);
+                memberProperties.clear();
+
+                for(auto member_name : memberNames)
+                {
+                    auto it = properties.find(member_name);
+
+                    memberProperties.push_back(it != properties.end() ? &it->second : nullptr);
+                }
+
+                memberIndexComplete = true;
+            }
+
+            // Position of name in the descriptor index, -1 when it is no member; -2 when there is no index or members were added since.
+            static int findMember(const std::string & name)
+            {
+                if(!memberIndexComplete)
+                {
+                    return -2;
+                }
+
+                auto it = std::lower_bound(memberNames.begin(), memberNames.end(), name, [](const char * member, const std::string & key) { return key.compare(member) > 0; });
+
+                return it != memberNames.end() && name == *it ? int(it - memberNames.begin()) : -1;
+            }
+
+            static const ClassProperty * findProperty(const std::string & name)
+            {
+                const int member = findMember(name);
+
+                if(member != -2)
+                {
+                    return member >= 0 ? memberProperties[member] : nullptr;
+                }
+
+                auto it = properties.find(name);
+
+                return it != properties.end() ? &it->second : nullptr;
+            }
+
+            static const std::vector<PropertySlot> & getSlots()
+            {
+                static std::vector<PropertySlot>
+                    slots;
+                static unsigned
+                    generation = 0;
+
+                if(generation != getPropertyGeneration())
+                {
+                    generation = getPropertyGeneration();
+                    slots.clear();
+
+                    for(auto & kv : properties)
+                    {
+                        slots.push_back({kv.first, &kv.second, 0});
+                    }
+
+                    addBaseSlots(slots, static_cast<typename GetBaseClasses<T>::value *>(nullptr));
+                }
+
+                return slots;
+            }
+
+            template<typename ... Bases>
+            static void addBaseSlots(std::vector<PropertySlot> & slots, std::tuple<Bases...> *)
+            {
+                (addSlots(slots, Class<Bases>::getSlots(), getUpcastOffset<T, Bases>()), ...);
+            }
+
+            static void addSlots(std::vector<PropertySlot> & slots, const std::vector<PropertySlot> & base_slots, const std::ptrdiff_t offset)
+            {
+                for(auto & slot : base_slots)
+                {
+                    if(std::none_of(slots.begin(), slots.end(), [&slot](const PropertySlot & other) { return other.name == slot.name; }))
+                    {
+                        slots.push_back({slot.name, slot.property, slot.offset + offset});
+                    }
+                }
+            }
+
+            static void * slotObject(void * object, const PropertySlot & slot)
+            {
+                return static_cast<char *>(object) + slot.offset;
+            }
+
+            static int findSlot(const std::string & name)
+            {
+                static std::map<std::string, int>
+                    index;
+                static unsigned
+                    generation = 0;
+
+                if(generation != getPropertyGeneration())
+                {
+                    auto & slots = getSlots();
+
+                    generation = getPropertyGeneration();
+                    index.clear();
+
+                    for(size_t i = 0; i < slots.size(); ++i)
+                    {
+                        index[slots[i].name] = int(i);
+                    }
+                }
+
+                auto it = index.find(name);
+
+                return it != index.end() ? it->second : -1;
+            }
+
+            static int findSlot(const CefRefPtr<CefV8Value> & key)
+            {
+                if(key->IsInt())
+                {
+                    int index = key->GetIntValue();
+
+                    return index >= 0 && index < int(getSlots().size()) ? index : -1;
+                }
+
+                return key->IsString() ? findSlot(key->GetStringValue().ToString()) : -1;
+            }
+
+            // obj.__read(["a", "b"]) or obj.__read([0, 1]): several properties in one call.
+            static void readProperties(CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments)
+            {
+                if(arguments.size() != 1 || !arguments[0]->IsArray())
+                {
+                    return;
+                }
+
+                auto & slots = getSlots();
+                int count = arguments[0]->GetArrayLength();
+
+                retval = CefV8Value::CreateArray(count);
+
+                for(int i = 0; i < count; ++i)
+                {
+                    int index = findSlot(arguments[0]->GetValue(i));
+                    CefRefPtr<CefV8Value> value;
+
+                    if(index >= 0)
+                    {
+                        readProperty(*slots[index].property, slotObject(object, slots[index]), value);
+                    }
+
+                    retval->SetValue(i, value ? value : createUndefined());
+                }
+            }
+
+            static void snapshotProperties(CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments)
+            {
+                retval = CefV8Value::CreateObject(nullptr);
+
+                for(auto & slot : getSlots())
+                {
+                    CefRefPtr<CefV8Value> value;
+
+                    readProperty(*slot.property, slotObject(object, slot), value);
+                    retval->SetValue(slot.name, value, V8_PROPERTY_ATTRIBUTE_NONE);
+                }
+            }
+
+            // obj.__assign({a: 1, b: 2}): returns false if a property is unknown, read-only or given a wrong value.
+            static void assignProperties(CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments)
+            {
+                bool assigned = arguments.size() == 1 && arguments[0]->IsObject();
+
+                if(assigned)
+                {
+                    auto & slots = getSlots();
+                    std::vector<CefString> keys;
+
+                    arguments[0]->GetKeys(keys);
+
+                    for(auto & key : keys)
+                    {
+                        int index = findSlot(key.ToString());
+
+                        if(index < 0 || !slots[index].property->writable || !writeProperty(*slots[index].property, slotObject(object, slots[index]), arguments[0]->GetValue(key)))
+                        {
+                            assigned = false;
+                        }
+                    }
+                }
+
+                retval = createBool(assigned);
+            }
+
+            static int findMethodBinding(const std::string & name)
+            {
+                auto it = methods.find(name);
+
+                if(it != methods.end())
+                {
+                    return it->second;
+                }
+
+                return findBaseMethodBinding(name, static_cast<typename GetBaseClasses<T>::value *>(nullptr));
+            }
+
+            template<typename ... Bases>
+            static int findBaseMethodBinding(const std::string & name, std::tuple<Bases...> *)
+            {
+                int binding = -1;
+
+                (void)((binding < 0 && (binding = Class<Bases>::findMethodBinding(name)) >= 0) || ...);
+
+                return binding;
+            }
+
+            // Module.<Class>.__invokeAll(name, objects, args...) and __map(...): one native call for the whole array.
+            static void callAll(CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments, const bool collect)
+            {
+                if(arguments.size() < 2 || !arguments[0]->IsString() || !arguments[1]->IsArray())
+                {
+                    throwTypeError(std::string(collect ? "__map" : "__invokeAll") + " expects a method name and an array");
+                    return;
+                }
+
+                const std::string method_name = arguments[0]->GetStringValue();
+                const int binding = findMethodBinding(method_name);
+
+                if(binding < 0)
+                {
+                    throwTypeError(name + " has no method " + method_name);
+                    return;
+                }
+
+                invokeOnArray(binding, arguments[1], CefV8ValueList(arguments.begin() + 2, arguments.end()), collect, retval);
+            }
+
+            static void invokeAll(CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            {
+                callAll(retval, arguments, false);
+            }
+
+            static void mapAll(CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            {
+                callAll(retval, arguments, true);
+            }
+
+            // The members every class gets; binding a user member under one of these names is rejected.
+            static bool isBuiltinName(const char *name)
+            {
+                static const char * const
+                    builtins[] = { "__read", "__snapshot", "__assign", "__invokeAll", "__map" };
+
+                return std::any_of(std::begin(builtins), std::end(builtins), [name](const char * builtin) { return strcmp(name, builtin) == 0; });
+            }
+
+            // Registering a name again adds an overload; the same signature replaces the previous one.
+            static void registerMethod(const char *name, const MethodFunction & method, const int arity = -1, OverloadMatcher matches = nullptr, const unsigned char * kinds = nullptr, const ClassIdFunction * classes = nullptr)
+            {
+                assert(!isBuiltinName(name) && "embindcefv8: method name reserved for a builtin");
+
+                if(!isBuiltinName(name))
+                {
+                    addMethod(name, method, arity, matches, kinds, classes);
+                }
+            }
+
+            static void registerFunction(const char *name, const ResultFunction & function, const int arity = -1, OverloadMatcher matches = nullptr, const unsigned char * kinds = nullptr, const ClassIdFunction * classes = nullptr)
+            {
+                assert(!isBuiltinName(name) && "embindcefv8: static function name reserved for a builtin");
+
+                if(!isBuiltinName(name))
+                {
+                    addFunction(name, function, arity, matches, kinds, classes);
+                }
+            }
+
+            static void addMethod(const char *name, const MethodFunction & method, const int arity = -1, OverloadMatcher matches = nullptr, const unsigned char * kinds = nullptr, const ClassIdFunction * classes = nullptr)
+            {
+                auto it = methods.find(name);
+
+                memberIndexComplete = false;
+
+                if(it == methods.end())
+                {
+                    it = methods.emplace(name, addBinding({BindingKind::Method, id, name, nullptr, method, nullptr, {}})).first;
+                }
+
+                addOverload(it->second, {arity, matches, kinds, classes, nullptr, method});
+            }
+
+            static void addFunction(const char *name, const ResultFunction & function, const int arity = -1, OverloadMatcher matches = nullptr, const unsigned char * kinds = nullptr, const ClassIdFunction * classes = nullptr)
+            {
+                auto it = staticFunctions.find(name);
+
+                if(it == staticFunctions.end())
+                {
+                    it = staticFunctions.emplace(name, addBinding({BindingKind::Function, id, name, function, nullptr, nullptr, {}})).first;
+                }
+
+                addOverload(it->second, {arity, matches, kinds, classes, function, nullptr});
+            }
+
+            // Called the first time Module.<name> is read in a context.
+            static CefRefPtr<CefV8Value> createConstructor(ContextRegistry & registry)
+            {
+                CefRefPtr<CefV8Value> constructor_func = createBindingFunction(constructorBinding);
+
+                for(auto& kv : staticFunctions)
+                {
+                    constructor_func->SetValue(kv.first, createBindingFunction(kv.second), V8_PROPERTY_ATTRIBUTE_NONE);
+                }
+
+                return constructor_func;
+            }
+
+            // Called the first time a member of an instance is read in a context.
+            static void createMethods(ContextRegistry & registry)
+            {
+                if(isExtensionClass(id))
+                {
+                    loadExtensionMethods(registry, id);
+                }
+                else
+                {
+                    auto & context_methods = registry.methods[id];
+
+                    for(auto& kv : methods)
+                    {
+                        context_methods[kv.first] = createBindingFunction(kv.second);
+                    }
+                }
+
+                registry.methodsReady[id] = true;
+            }
+
+            // Like registerMethod, a name registered again adds an overload and the same signature replaces the previous one.
+            static void registerProxyMethod(const char *name, ProxyMethodFunction method, const int arity, const unsigned char * kinds, const WireIdFunction * argument_objects)
+            {
+                auto & info = getClasses()[id];
+                ProxySignature signature {kinds, {argument_objects, argument_objects + arity}};
+
+                for(size_t i = 0; i < info.methodNames.size(); ++i)
+                {
+                    if(info.methodNames[i] == name && info.methodSignatures[i].isSameAs(signature))
+                    {
+                        info.methods[i] = method;
+                        info.methodSignatures[i] = signature;
+                        return;
+                    }
+                }
+
+                info.methodNames.push_back(name);
+                info.methods.push_back(method);
+                info.methodSignatures.push_back(signature);
+            }
+
+            static void wrap(CefRefPtr<CefV8Value>& retval, const void * object)
+            {
+                ValueCreator<T>::wrap(retval, * static_cast<const T *>(object));
+            }
+
+            template<typename ... Bases>
+            static std::vector<std::pair<int (*)(), std::ptrdiff_t>> getBaseOffsets(std::tuple<Bases...> *)
+            {
+                return { { &ClassId<Bases>::get, getUpcastOffset<T, Bases>() } ... };
+            }
+
+            static auto getDowncast() -> const void * (*)(const void *)
+            {
+                using Base = typename GetBaseClass<T>::value;
+
+                if constexpr(!std::is_void_v<Base> && std::is_polymorphic_v<Base>)
+                {
+                    return [](const void * object) -> const void * {
+                        return dynamic_cast<const T *>(static_cast<const Base *>(object));
+                    };
+                }
+                else
+                {
+                    return nullptr;
+                }
+            }
+
+            static void registerProxyFunction(const char *name, ProxyFunction function, const int arity, const unsigned char * kinds, const WireIdFunction * argument_objects)
+            {
+                auto & info = getClasses()[id];
+                ProxySignature signature {kinds, {argument_objects, argument_objects + arity}};
+
+                for(size_t i = 0; i < info.staticFunctionNames.size(); ++i)
+                {
+                    if(info.staticFunctionNames[i] == name && info.staticFunctionSignatures[i].isSameAs(signature))
+                    {
+                        info.staticFunctions[i] = function;
+                        info.staticFunctionSignatures[i] = signature;
+                        return;
+                    }
+                }
+
+                info.staticFunctionNames.push_back(name);
+                info.staticFunctions.push_back(function);
+                info.staticFunctionSignatures.push_back(signature);
+            }
+        #endif
+
+        static std::string
+            name;
+        #ifdef EMSCRIPTEN
+            emscripten::class_<T, EmscriptenBaseClass>
+                * emClass;
+        #else
+            static std::map<std::string, ClassProperty>
+                properties;
+            // Binding ids, see getBindings().
+            static std::map<std::string, int>
+                staticFunctions;
+            static std::map<std::string, int>
+                methods;
+            // Sorted instance member names from a compile-time descriptor, with the property of each (null for methods).
+            static std::vector<const char *>
+                memberNames;
+            static std::vector<const ClassProperty *>
+                memberProperties;
+            // Set by setMemberIndex, cleared when a member is registered afterwards.
+            static bool
+                memberIndexComplete;
+            static CefRefPtr<ClassAccessor<T>>
+                classAccessor;
+            static int
+                id,
+                constructorBinding;
+            static bool
+                isPolymorphic;
+        #endif
+    };
+
+    template<class T>
+    std::string ValueObject<T>::name;
+
+    template<class T>
+    std::string Class<T>::name;
+
+    #ifdef CEF
+        template<class T>
+        std::map<std::string, GetterFunction> ValueObject<T>::getters;
+        template<class T>
+        std::map<std::string, SetterFunction> ValueObject<T>::setters;
+        template<class T>
+        std::map<std::string, GetterFunction> ValueObject<T>::views;
+        template<class T>
+        std::vector<BindingOverload> ValueObject<T>::constructors;
+        template<class T>
+        int ValueObject<T>::wireId = -1;
+
+        template<class T>
+        std::map<std::string, ClassProperty> Class<T>::properties;
+        template<class T>
+        std::map<std::string, int> Class<T>::staticFunctions;
+        template<class T>
+        std::map<std::string, int> Class<T>::methods;
+        template<class T>
+        std::vector<const char *> Class<T>::memberNames;
+        template<class T>
+        std::vector<const ClassProperty *> Class<T>::memberProperties;
+        template<class T>
+        bool Class<T>::memberIndexComplete = false;
+        template<class T>
+        int Class<T>::id = -1;
+        template<class T>
+        int Class<T>::constructorBinding = -1;
+        template<class T>
+        bool Class<T>::isPolymorphic = false;
+
+        template<typename T>
+        class ClassAccessor : public CefV8Accessor
+        {
+        public:
+            ClassAccessor() : CefV8Accessor()
+            {
+            }
+
+            virtual bool Get(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception) override
+            {
+                return get(name, object, retval, exception);
+            }
+
+            static bool get(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception)
+            {
+                return internalGet(name, object, retval, exception);
+            }
+
+            static bool getOwn(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval)
+            {
+                const std::string key = name;
+                const int member = Class<T>::findMember(key);
+
+                if(member == -1)
+                {
+                    return false;
+                }
+
+                const ClassProperty * property = member >= 0 ? Class<T>::memberProperties[member] : Class<T>::findProperty(key);
+
+                if(property)
+                {
+                    readProperty(*property, getObject(*dynamic_cast<UserData*>(object->GetUserData().get()), Class<T>::id), retval);
+                    return true;
+                }
+
+                ContextRegistry * registry = getContextRegistry();
+
+                if(registry)
+                {
+                    if(!registry->methodsReady[Class<T>::id])
+                    {
+                        Class<T>::createMethods(*registry);
+                    }
+
+                    auto & methods = registry->methods[Class<T>::id];
+                    auto it = methods.find(key);
+
+                    if(it != methods.end())
+                    {
+                        retval = it->second;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            static bool internalGet(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception)
+            {
+                return getOwn(name, object, retval) || getFromBases(name, object, retval, exception, static_cast<typename GetBaseClasses<T>::value *>(nullptr));
+            }
+
+            template<typename ... Bases>
+            static bool getFromBases(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception, std::tuple<Bases...> *)
+            {
+                return (ClassAccessor<Bases>::get(name, object, retval, exception) || ...);
+            }
+
+            virtual bool Set(const CefString& name, const CefRefPtr<CefV8Value> object, const CefRefPtr<CefV8Value> value, CefString& exception) override
+            {
+                ScratchScope scratch_scope;
+
+                return set(name, object, value, exception);
+            }
+
+            static bool set(const CefString& name, const CefRefPtr<CefV8Value> object, const CefRefPtr<CefV8Value> value, CefString& exception)
+            {
+                return internalSet(name, object, value, exception);
+            }
+
+            static bool setOwn(const CefString& name, const CefRefPtr<CefV8Value> object, const CefRefPtr<CefV8Value> value, CefString& exception)
+            {
+                const ClassProperty * property = Class<T>::findProperty(name);
+
+                if(!property || !property->writable)
+                {
+                    return false;
+                }
+
+                if(!writeProperty(*property, getObject(*dynamic_cast<UserData*>(object->GetUserData().get()), Class<T>::id), value))
+                {
+                    exception = "embindcefv8: invalid value for " + name.ToString();
+                }
+
+                return true;
+            }
+
+            static bool internalSet(const CefString& name, const CefRefPtr<CefV8Value> object, const CefRefPtr<CefV8Value> value, CefString& exception)
+            {
+                return setOwn(name, object, value, exception) || setInBases(name, object, value, exception, static_cast<typename GetBaseClasses<T>::value *>(nullptr));
+            }
+
+            template<typename ... Bases>
+            static bool setInBases(const CefString& name, const CefRefPtr<CefV8Value> object, const CefRefPtr<CefV8Value> value, CefString& exception, std::tuple<Bases...> *)
+            {
+                return (ClassAccessor<Bases>::set(name, object, value, exception) || ...);
+            }
+
+            IMPLEMENT_REFCOUNTING(ClassAccessor);
+        };
+
+        template<class T>
+        CefRefPtr<ClassAccessor<T>> Class<T>::classAccessor = new ClassAccessor<T>();
+
+        // A value object embedded in a wrapped instance, read and written in place instead of copied.
+        template<typename V>
+        struct ValueObjectView : public CefV8Accessor
+        {
+            static void create(CefRefPtr<CefV8Value>& retval, V * value)
+            {
+                static CefRefPtr<ValueObjectView<V>>
+                    accessor = new ValueObjectView<V>();
+
+                retval = CefV8Value::CreateObject(&*accessor);
+                retval->SetUserData(new UserData(value));
+
+                for(auto& kv : ValueObject<V>::getters)
+                {
+                    retval->SetValue(kv.first, V8_ACCESS_CONTROL_DEFAULT, V8_PROPERTY_ATTRIBUTE_NONE);
+                }
+            }
+
+            virtual bool Get(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception) override
+            {
+                void * data = dynamic_cast<UserData*>(object->GetUserData().get())->data;
+                auto view = ValueObject<V>::views.find(name);
+
+                if(view != ValueObject<V>::views.end())
+                {
+                    view->second(retval, data);
+                    return true;
+                }
+
+                auto it = ValueObject<V>::getters.find(name);
+
+                if(it == ValueObject<V>::getters.end())
+                {
+                    return false;
+                }
+
+                it->second(retval, data);
+                return true;
+            }
+
+            virtual bool Set(const CefString& name, const CefRefPtr<CefV8Value> object, const CefRefPtr<CefV8Value> value, CefString& exception) override
+            {
+                ScratchScope scratch_scope;
+                auto it = ValueObject<V>::setters.find(name);
+
+                if(it == ValueObject<V>::setters.end())
+                {
+                    return false;
+                }
+
+                it->second(dynamic_cast<UserData*>(object->GetUserData().get())->data, value);
+                return true;
+            }
+
+            IMPLEMENT_REFCOUNTING(ValueObjectView);
+        };
+
+        template<typename T>
+        struct ValueCreator
+        {
+            template<class Q = T>
+            static
+            std::enable_if_t<IsValueObject<Q>::value, void>
+            create(CefRefPtr<CefV8Value>& retval, const T& value)
+            {
+                retval = CefV8Value::CreateObject(nullptr);
+
+                for(auto& kv : ValueObject<T>::getters)
+                {
+                    CefRefPtr<CefV8Value> field_value;
+                    kv.second(field_value, (void*) &value);
+                    retval->SetValue(kv.first, field_value, V8_PROPERTY_ATTRIBUTE_NONE);
+                }
+            }
+
+            template<class Q = T>
+            static
+            std::enable_if_t<!IsValueObject<Q>::value, void>
+            create(CefRefPtr<CefV8Value>& retval, const T& value)
             {
-                return internalCall(std::index_sequence_for<Args...>{}, arguments);
+                if constexpr(std::is_polymorphic_v<T>)
+                {
+                    if(Class<T>::isPolymorphic && typeid(value) != typeid(T) && wrapMostDerived(retval, &value, dynamic_cast<const void *>(&value), typeid(value), Class<T>::id))
+                    {
+                        return;
+                    }
+                }
+
+                wrap(retval, value);
             }
 
-        private:
-            template<std::size_t... Is>
-            static T * internalCall(std::index_sequence<Is...>, const CefV8ValueList& arguments)
+            static void wrap(CefRefPtr<CefV8Value>& retval, const T& value)
             {
-                return new T((ValueConverter<GetArgType<Is>>::get(*arguments[Is])) ...);
+                retval = CefV8Value::CreateObject(&*Class<T>::classAccessor);
+
+                retval->SetUserData(new UserData(& value, Class<T>::id));
+
+                setGettersAndMethods(retval, value);
+            }
+
+            static void setProperties(CefRefPtr<CefV8Value>& retval, const T& value)
+            {
+                for(auto& kv : Class<T>::properties)
+                {
+                    if(kv.second.constant)
+                    {
+                        CefRefPtr<CefV8Value> constant_value;
+
+                        readProperty(kv.second, (void*) &value, constant_value);
+                        retval->SetValue(kv.first, constant_value, V8_PROPERTY_ATTRIBUTE_READONLY);
+                    }
+                    else
+                    {
+                        retval->SetValue(kv.first, V8_ACCESS_CONTROL_DEFAULT, kv.second.writable ? V8_PROPERTY_ATTRIBUTE_NONE : V8_PROPERTY_ATTRIBUTE_READONLY);
+                    }
+                }
+            }
+
+            static void setGettersAndMethods(CefRefPtr<CefV8Value>& retval, const T& value)
+            {
+                setProperties(retval, value);
+
+                for(auto& kv : Class<T>::methods)
+                {
+                    retval->SetValue(kv.first, V8_ACCESS_CONTROL_DEFAULT, V8_PROPERTY_ATTRIBUTE_NONE);
+                }
+
+                setBaseGettersAndMethods(retval, value, static_cast<typename GetBaseClasses<T>::value *>(nullptr));
+            }
+
+            template<typename ... Bases>
+            static void setBaseGettersAndMethods(CefRefPtr<CefV8Value>& retval, const T& value, std::tuple<Bases...> *)
+            {
+                (ValueCreator<Bases>::setGettersAndMethods(retval, value), ...);
             }
         };
     #endif
 
-    template<class T>
-    class ValueObject
+    void executeJavaScript(const char *str);
+
+    // Queues a script; the queue is flushed on the next loop iteration with a single execution in which each script runs
+    // through its own global eval. On a CEF thread without a task runner the script is executed immediately instead.
+    void queueJavaScript(const char *str);
+    void flushJavaScript();
+
+    // A function expression compiled once per context and then called directly from C++.
+    class JavaScriptFunction
     {
     public:
-        ValueObject(const char *_name)
-        {
-            name = _name;
-
+        JavaScriptFunction(const char *_code)
+            :
+            code(std::string("(") + _code + ")")
+            #ifdef CEF
+                , id(nextId++)
+            #endif
             #ifdef EMSCRIPTEN
-                emVo = new emscripten::value_object<T>(_name);
+                , function(emscripten::val::undefined())
             #endif
+        {
         }
 
-        ~ValueObject()
+        template<typename Result = void, typename ... Args>
+        Result call(const Args & ... args)
         {
             #ifdef EMSCRIPTEN
-                delete emVo;
+                compile();
+
+                if constexpr(std::is_void_v<Result>)
+                {
+                    function(args...);
+                }
+                else
+                {
+                    return function(args...).template as<Result>();
+                }
             #else
-                if(constructors.size())
+                if(!enter())
                 {
-                    auto copied_name = name;
-
-                    getRegisterers().push_back(
-                        [copied_name](CefRefPtr<CefV8Value> & module_object)
-                        {
-                            ResultFunction fc = [](CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments) {
-                                T * new_object;
-                                constructors[arguments.size()]((void*&)new_object, arguments);
-                                ValueCreator<T>::create(retval, * new_object);
-                            };
-
-                            CefRefPtr<CefV8Value> constructor_func = CefV8Value::CreateFunction(copied_name.c_str(), new FuncHandler(fc));
-                            module_object->SetValue(copied_name.c_str(), constructor_func, V8_PROPERTY_ATTRIBUTE_NONE);
-                        }
-                    );
+                    return Result();
                 }
-            #endif
-        }
 
-        template<typename ... Args>
-        ValueObject & constructor()
-        {
-            #ifdef EMSCRIPTEN
-                T ( * func )(Args && ... args) =
-                    [](Args && ... args) -> T
-                    {
-                        return T(std::forward<Args&&>( args )...);
-                    };
+                CefV8ValueList arguments;
+                (appendArgument(arguments, args), ...);
 
-                emscripten::function(name.c_str(), func);
-            #else
-                constructors[sizeof...(Args)] = [](void * & object, const CefV8ValueList& arguments) {
-                    T * new_object = ConstructorInvoker<T, Args...>::call(arguments);
-                    object = new_object;
-                };
-            #endif
+                CefRefPtr<CefV8Value> retval = invoke(arguments);
 
-            return *this;
-        }
+                if constexpr(std::is_void_v<Result>)
+                {
+                    exit();
+                }
+                else
+                {
+                    static_assert(!IsScratchString<Result>, "a string view would not outlive the call, use std::string");
 
-        template<class F>
-        ValueObject & property(const char *name, F (T::*field))
-        {
-            #ifdef EMSCRIPTEN
-                emVo->field(name, field);
-            #else
-                getters[name] = [field](CefRefPtr<CefV8Value>& retval, void * object) {
-                    ValueCreatorCaller<F>::create(retval, (*(T *)object).*field);
-                };
-                setters[name] = [field](void * object, const CefRefPtr<CefV8Value>& cef_value) {
-                    (*(T *)object).*field = ValueConverter<F>::get(*cef_value);
-                };
+                    Result result = retval && acceptsValue<Result>(retval) ? Result(ValueConverter<Result>::get(*retval)) : Result();
+                    exit();
+                    return result;
+                }
             #endif
-
-            return *this;
         }
 
-        template<typename C>
-        friend class ValueCreator;
+    private:
+        #ifdef EMSCRIPTEN
+            void compile();
+        #else
+            template<typename T>
+            static void appendArgument(CefV8ValueList & arguments, const T & value)
+            {
+                CefRefPtr<CefV8Value> argument;
+                ValueCreatorCaller<T>::create(argument, value);
+                arguments.push_back(argument);
+            }
 
-        template<typename C, class>
-        friend class ValueConverter;
+            bool enter();
+            CefRefPtr<CefV8Value> invoke(const CefV8ValueList & arguments);
+            void exit();
+        #endif
 
-    private:
-        static std::string
-            name;
+        std::string
+            code;
         #ifdef EMSCRIPTEN
-            emscripten::value_object<T>
-                * emVo;
+            emscripten::val
+                function;
         #else
-            static std::map<std::string, GetterFunction>
-                getters;
-            static std::map<std::string, SetterFunction>
-                setters;
-            static std::map<int, ConstructorFunction>
-                constructors;
+            int
+                id;
+            ContextRegistry
+                * entered = nullptr,
+                * outerRegistry = nullptr;
+            CefRefPtr<CefV8Value>
+                function;
+            static int
+                nextId;
         #endif
     };
 
-    template<class T>
-    class Class
+    template<typename T>
+    void addGlobalObject(const T & object, const char *name)
     {
-    public:
+        #ifdef CEF
+            std::string copied_name = name;
+            const T * copied_object = & object;
 
-        #ifdef EMSCRIPTEN
-        using EmscriptenBaseClass = std::conditional_t<std::is_void_v<typename GetBaseClass<T>::value>, emscripten::internal::NoBaseClass, emscripten::base<typename GetBaseClass<T>::value>>;
-        #endif
+            Registerer registerer = [copied_name, copied_object](ContextRegistry & registry)
+                {
+                    CefRefPtr<CefV8Value> new_value;
 
-        Class() = delete;
+                    ValueCreator<T>::create(new_value, * copied_object);
 
-        Class(const char *_name)
-        {
-            name = _name;
+                    registry.moduleObject->SetValue(copied_name, new_value, V8_PROPERTY_ATTRIBUTE_NONE);
+                };
 
-            #ifdef EMSCRIPTEN
-                emClass = new emscripten::class_<T, EmscriptenBaseClass>(_name);
-            #endif
-        }
+            getRegisterers().push_back(registerer);
+            installInContexts(registerer);
+        #else
+            emscripten::val::global( "Module" ).set( name, emscripten::val( object ) );
+        #endif
+    }
 
-        ~Class()
-        {
-            #ifdef EMSCRIPTEN
-                if(emClass)
-                    delete emClass;
-            #else
-                auto copied_name = name;
+    // Compile-time binding descriptors:
+    //   static constexpr auto desc = class_<T>("T", ctor<int>, prop<&T::x>("x"), method<&T::f>("f"), static_function<&T::g>("g"));
+    //   desc.install();
+    // Member pointers are template arguments, so every trampoline is a plain function instantiated at compile time.
+    template<typename F>
+    struct MemberFunctionTraits;
 
-                getRegisterers().push_back(
-                    [copied_name](CefRefPtr<CefV8Value> & module_object)
-                    {
-                        ResultFunction fc = [](CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments) {
-                            T * new_object;
-                            constructors[arguments.size()]((void*&)new_object, arguments);
-                            ValueCreator<T>::create(retval, * new_object);
-                        };
+    template<typename T, typename Result, typename ... Args>
+    struct MemberFunctionTraits<Result (T::*)(Args...)>
+    {
+        using Class = T;
+        using ResultType = Result;
+        #ifdef CEF
+            using Invoker = MethodInvoker<T, Result, Args...>;
+            using ProxyInvoker = ProxyMethodInvoker<T, Result, Args...>;
+
+            static constexpr int
+                arity = sizeof...(Args);
+            static constexpr OverloadMatcher
+                matches = &matchesArguments<Args...>;
+            static constexpr const unsigned char
+                * kinds = ArgumentKinds<Args...>::value;
+            static constexpr const ClassIdFunction
+                * classes = ArgumentClasses<Args...>::value;
+            static constexpr const WireIdFunction
+                * wireObjects = ArgumentWireObjects<Args...>::value;
+        #endif
+    };
 
-                        CefRefPtr<CefV8Value> constructor_func = CefV8Value::CreateFunction(copied_name.c_str(), new FuncHandler(fc));
+    template<typename T, typename Result, typename ... Args>
+    struct MemberFunctionTraits<Result (T::*)(Args...) const> : MemberFunctionTraits<Result (T::*)(Args...)>
+    {
+    };
 
-                        for(auto& kv : staticFunctions)
-                        {
-                            constructor_func->SetValue(kv.first, kv.second, V8_PROPERTY_ATTRIBUTE_NONE);
-                        }
+    template<typename F>
+    struct FunctionTraits;
 
-                        module_object->SetValue(copied_name.c_str(), constructor_func, V8_PROPERTY_ATTRIBUTE_NONE);
-                    }
-                );
-            #endif
-        }
+    template<typename Result, typename ... Args>
+    struct FunctionTraits<Result (*)(Args...)>
+    {
+        #ifdef CEF
+            using Invoker = FunctionInvoker<Result, Args...>;
+            using ProxyInvoker = ProxyFunctionInvoker<Result, Args...>;
+
+            static constexpr int
+                arity = sizeof...(Args);
+            static constexpr OverloadMatcher
+                matches = &matchesArguments<Args...>;
+            static constexpr const unsigned char
+                * kinds = ArgumentKinds<Args...>::value;
+            static constexpr const ClassIdFunction
+                * classes = ArgumentClasses<Args...>::value;
+            static constexpr const WireIdFunction
+                * wireObjects = ArgumentWireObjects<Args...>::value;
+        #endif
+    };
 
-        template<typename ... Args>
-        Class & constructor()
+    // Compile-time name order, the same as std::string::compare.
+    constexpr int compareNames(const char * a, const char * b)
+    {
+        for(; *a && *a == *b; ++a, ++b)
         {
-            #ifdef EMSCRIPTEN
-                emClass->template constructor<Args...>();
-            #else
-                constructors[sizeof...(Args)] = [](void * & object, const CefV8ValueList& arguments) {
-                    T * new_object = ConstructorInvoker<T, Args...>::call(arguments);
-                    object = new_object;
-                };
-            #endif
-
-            return *this;
         }
 
-        template<class F>
-        Class & property(const char *name, F (T::*field))
-        {
-            #ifdef EMSCRIPTEN
-                emClass->property(name, field);
-            #else
-                getters[name] = [field](CefRefPtr<CefV8Value>& retval, void * object) {
-                    ValueCreatorCaller<F>::create(retval, (*(T *)object).*field);
-                };
-            #endif
+        return int(static_cast<unsigned char>(*a)) - int(static_cast<unsigned char>(*b));
+    }
 
-            return *this;
-        }
+    template<std::size_t N>
+    struct SortedNames
+    {
+        const char
+            * names[N];
+        int
+            count;
+    };
 
-        template<typename Result, typename ... Args>
-        Class & method(const char *name, Result (T::*field)(Args...))
+    // Insertion sort at compile time; null names are skipped and repeated ones, such as overloads, kept once.
+    template<std::size_t N>
+    constexpr SortedNames<N> sortNames(const std::array<const char *, N> & names)
+    {
+        SortedNames<N> result {};
+
+        for(const char * name : names)
         {
-            #ifdef EMSCRIPTEN
-                emClass->function(name, field, emscripten::allow_raw_pointers());
-            #else
-                MethodFunction m = [field](CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments) {
-                    MethodInvoker<T, Result, Args...>::call(field, object, retval, arguments);
-                };
+            int position = 0;
 
-                methods[name] = CefV8Value::CreateFunction(name, new MethodHandler(m));
-            #endif
+            if(!name)
+            {
+                continue;
+            }
 
-            return *this;
-        }
+            while(position < result.count && compareNames(result.names[position], name) < 0)
+            {
+                ++position;
+            }
 
-        template<typename Result, typename ... Args>
-        Class & method(const char *name, Result (T::*field)(Args...) const)
-        {
-            #ifdef EMSCRIPTEN
-                emClass->function(name, field, emscripten::allow_raw_pointers());
-            #else
-                MethodFunction m = [field](CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments) {
-                    MethodInvoker<T, Result, Args...>::call(field, object, retval, arguments);
-                };
+            if(position < result.count && compareNames(result.names[position], name) == 0)
+            {
+                continue;
+            }
 
-                methods[name] = CefV8Value::CreateFunction(name, new MethodHandler(m));
-            #endif
+            for(int i = result.count; i > position; --i)
+            {
+                result.names[i] = result.names[i - 1];
+            }
 
-            return *this;
+            result.names[position] = name;
+            ++result.count;
         }
 
-        template<typename ... Args>
-        Class & method(const char *name, void (T::*field)(Args...))
-        {
-            #ifdef EMSCRIPTEN
-                emClass->function(name, field, emscripten::allow_raw_pointers());
-            #else
-                MethodFunction m = [field](CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments) {
-                    MethodInvoker<T, void, Args...>::call(field, object, arguments);
-                };
-
-                methods[name] = CefV8Value::CreateFunction(name, new MethodHandler(m));
-            #endif
+        return result;
+    }
 
-            return *this;
+    template<typename ... Args>
+    struct ConstructorDescriptor
+    {
+        constexpr const char * memberName() const
+        {
+            return nullptr;
         }
 
-        template<typename ... Args>
-        Class & method(const char *name, void (T::*field)(Args...) const)
+        template<class T>
+        void install(Class<T> & target) const
         {
-            #ifdef EMSCRIPTEN
-                emClass->function(name, field, emscripten::allow_raw_pointers());
-            #else
-                MethodFunction m = [field](CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments) {
-                    MethodInvoker<T, void, Args...>::call(field, object, arguments);
-                };
+            target.template constructor<Args...>();
+        }
+    };
+
+    template<typename ... Args>
+    constexpr ConstructorDescriptor<Args...> ctor {};
 
-                methods[name] = CefV8Value::CreateFunction(name, new MethodHandler(m));
-            #endif
+    template<auto Field>
+    struct PropertyDescriptor
+    {
+        const char
+            * name;
 
-            return *this;
+        constexpr const char * memberName() const
+        {
+            return name;
         }
 
-        template<typename Result, typename ... Args>
-        Class & static_function(const char *name, Result (*staticFunction)(Args...))
+        template<class T>
+        void install(Class<T> & target) const
         {
             #ifdef EMSCRIPTEN
-                emClass->class_function(name, staticFunction, emscripten::allow_raw_pointers());
+                target.property(name, Field);
             #else
-                ResultFunction m = [staticFunction](CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments) {
-                    FunctionInvoker<Result, Args...>::call(staticFunction, retval, arguments);
-                };
-
-                staticFunctions[name] = CefV8Value::CreateFunction(name, new FuncHandler(m));
+                Class<T>::registerProperty(name, Field, true);
             #endif
-
-            return *this;
         }
-
-        template<typename C>
-        friend class ValueCreator;
-        template<typename C>
-        friend class ClassAccessor;
-
-    //private:
-        static std::string
-            name;
-        #ifdef EMSCRIPTEN
-            emscripten::class_<T, EmscriptenBaseClass>
-                * emClass;
-        #else
-            static std::map<std::string, GetterFunction>
-                getters;
-            static std::map<int, ConstructorFunction>
-                constructors;
-            static std::map<std::string, CefRefPtr<CefV8Value>>
-                staticFunctions;
-            static std::map<std::string, CefRefPtr<CefV8Value>>
-                methods;
-            static CefRefPtr<ClassAccessor<T>>
-                classAccessor;
-        #endif
     };
 
-    template<class T>
-    std::string ValueObject<T>::name;
+    template<auto Field>
+    constexpr PropertyDescriptor<Field> prop(const char *name)
+    {
+        return {name};
+    }
 
-    template<class T>
-    std::string Class<T>::name;
+    template<auto Method>
+    struct MethodDescriptor
+    {
+        const char
+            * name;
 
-    #ifdef CEF
-        template<class T>
-        std::map<std::string, GetterFunction> ValueObject<T>::getters;
-        template<class T>
-        std::map<std::string, SetterFunction> ValueObject<T>::setters;
-        template<class T>
-        std::map<int, ConstructorFunction> ValueObject<T>::constructors;
+        constexpr const char * memberName() const
+        {
+            return name;
+        }
 
         template<class T>
-        std::map<std::string, GetterFunction> Class<T>::getters;
-        template<class T>
-        std::map<int, ConstructorFunction> Class<T>::constructors;
-        template<class T>
-        std::map<std::string, CefRefPtr<CefV8Value>> Class<T>::staticFunctions;
-        template<class T>
-        std::map<std::string, CefRefPtr<CefV8Value>> Class<T>::methods;
-
-        template<typename T>
-        class ClassAccessor : public CefV8Accessor
+        void install(Class<T> & target) const
         {
-        public:
-            ClassAccessor() : CefV8Accessor()
-            {
-            }
-
-            virtual bool Get(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception) override
-            {
-                return get(name, object, retval, exception);
-            }
+            #ifdef EMSCRIPTEN
+                target.method(name, Method);
+            #else
+                Class<T>::registerProxyMethod(name, &callProxy, Traits::arity, Traits::kinds, Traits::wireObjects);
+                Class<T>::registerMethod(name, &call, Traits::arity, Traits::matches, Traits::kinds, Traits::classes);
+            #endif
+        }
 
-            static bool get(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception)
-            {
-                return internalGet(name, object, retval, exception);
-            }
+        #ifdef CEF
+            using Traits = MemberFunctionTraits<decltype(Method)>;
 
-            template<class Q = T>
-            static
-            std::enable_if_t<std::is_void_v<typename GetBaseClass<Q>::value>, bool>
-            internalGet(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception)
+            static void call(CefRefPtr<CefV8Value>& retval, void * object, const CefV8ValueList& arguments)
             {
+                if constexpr(std::is_void_v<typename Traits::ResultType>)
                 {
-                    auto it = Class<T>::getters.find(name);
-
-                    if(it != Class<T>::getters.end())
-                    {
-                        it->second(retval, dynamic_cast<UserData*>(object->GetUserData().get())->data);
-                        return true;
-                    }
+                    Traits::Invoker::call(Method, object, arguments);
                 }
-
+                else
                 {
-                    auto it = Class<T>::methods.find(name);
-
-                    if(it != Class<T>::methods.end())
-                    {
-                        retval = it->second;
-                        return true;
-                    }
+                    Traits::Invoker::call(Method, object, retval, arguments);
                 }
-
-                return false;
             }
 
-            template<class Q = T>
-            static
-            std::enable_if_t<!std::is_void_v<typename GetBaseClass<Q>::value>, bool>
-            internalGet(const CefString& name, const CefRefPtr<CefV8Value> object, CefRefPtr<CefV8Value>& retval, CefString& exception)
+            static bool callProxy(WireWriter & writer, void * object, WireReader & reader, const int argument_count)
             {
-                {
-                    auto it = Class<T>::getters.find(name);
+                return Traits::ProxyInvoker::call(Method, object, writer, reader, argument_count);
+            }
+        #endif
+    };
 
-                    if(it != Class<T>::getters.end())
-                    {
-                        it->second(retval, dynamic_cast<UserData*>(object->GetUserData().get())->data);
-                        return true;
-                    }
-                }
+    template<auto Method>
+    constexpr MethodDescriptor<Method> method(const char *name)
+    {
+        return {name};
+    }
 
-                {
-                    auto it = Class<T>::methods.find(name);
+    template<auto Function>
+    struct FunctionDescriptor
+    {
+        const char
+            * name;
 
-                    if(it != Class<T>::methods.end())
-                    {
-                        retval = it->second;
-                        return true;
-                    }
-                }
+        // Static functions live on the constructor, outside the instance member index.
+        constexpr const char * memberName() const
+        {
+            return nullptr;
+        }
+
+        template<class T>
+        void install(Class<T> & target) const
+        {
+            #ifdef EMSCRIPTEN
+                target.static_function(name, Function);
+            #else
+                Class<T>::registerProxyFunction(name, &callProxy, Traits::arity, Traits::kinds, Traits::wireObjects);
+                Class<T>::registerFunction(name, &call, Traits::arity, Traits::matches, Traits::kinds, Traits::classes);
+            #endif
+        }
 
-                using baseType = typename GetBaseClass<Q>::value;
+        #ifdef CEF
+            using Traits = FunctionTraits<decltype(Function)>;
 
-                return ClassAccessor<baseType>::get(name, object, retval, exception);
+            static void call(CefRefPtr<CefV8Value>& retval, const CefV8ValueList& arguments)
+            {
+                Traits::Invoker::call(Function, retval, arguments);
             }
 
-            virtual bool Set(const CefString& name, const CefRefPtr<CefV8Value> object, const CefRefPtr<CefV8Value> value, CefString& exception) override
+            static bool callProxy(WireWriter & writer, WireReader & reader, const int argument_count)
             {
-                return false;
+                return Traits::ProxyInvoker::call(Function, writer, reader, argument_count);
             }
+        #endif
+    };
 
-            IMPLEMENT_REFCOUNTING(ClassAccessor);
-        };
+    template<auto Function>
+    constexpr FunctionDescriptor<Function> static_function(const char *name)
+    {
+        return {name};
+    }
 
-        template<class T>
-        CefRefPtr<ClassAccessor<T>> Class<T>::classAccessor = new ClassAccessor<T>();
+    template<class T, typename ... Members>
+    struct ClassDescriptor
+    {
+        const char
+            * name;
+        std::tuple<Members...>
+            members;
+        // Instance member names and the __read, __snapshot and __assign methods every class gets, sorted at compile time.
+        SortedNames<sizeof...(Members) + 3>
+            index;
+
+        void install() const
+        {
+            Class<T> target(name);
+
+            std::apply([&target](const auto & ... member) { (member.install(target), ...); }, members);
+
+            #ifdef CEF
+                Class<T>::setMemberIndex(index.names, index.count);
+            #endif
+        }
+    };
+
+    template<class T, typename ... Members>
+    constexpr ClassDescriptor<T, Members...> class_(const char *name, const Members & ... members)
+    {
+        return {name, {members...}, sortNames(std::array<const char *, sizeof...(Members) + 3>{{members.memberName() ..., "__read", "__snapshot", "__assign"}})};
+    }
 
+    #ifdef CEF
+        // Browser process only: exposes a live object to renderer processes, where every method call returns a Promise.
         template<typename T>
-        struct ValueCreator
+        void addProxyObject(T & object, const char *name)
         {
-            template<class Q = T>
-            static
-            std::enable_if_t<IsValueObject<Q>::value, void>
-            create(CefRefPtr<CefV8Value>& retval, const T& value)
-            {
-                retval = CefV8Value::CreateObject(nullptr);
+            ensureBindings();
 
-                for(auto& kv : ValueObject<T>::getters)
-                {
-                    CefRefPtr<CefV8Value> field_value;
-                    kv.second(field_value, (void*) &value);
-                    retval->SetValue(kv.first, field_value, V8_PROPERTY_ATTRIBUTE_NONE);
-                }
-            }
+            const int class_id = ClassId<T>::get();
 
-            template<class Q = T>
-            static
-            std::enable_if_t<!IsValueObject<Q>::value, void>
-            create(CefRefPtr<CefV8Value>& retval, const T& value)
+            if(class_id >= 0)
             {
-                retval = CefV8Value::CreateObject(&*Class<T>::classAccessor);
+                addProxyGlobal(name, getProxyHandle(& object, class_id), class_id);
+            }
+        }
+
+        // Invalidates every handle given out for object, whichever class it went out as; call it before destroying an exposed object.
+        template<typename T>
+        void removeProxyObject(T & object)
+        {
+            removeProxyObject(const_cast<std::remove_const_t<T> *>(& object), ClassId<std::remove_const_t<T>>::get());
+        }
 
-                retval->SetUserData(new UserData(& value));
+        // Packed form of a value object or container: fields in declaration order, no field names.
+        template<typename T>
+        CefRefPtr<CefBinaryValue> serialize(const T & value)
+        {
+            ensureBindings();
 
-                setGettersAndMethods(retval, value);
-            }
+            WireWriter writer;
 
-            template<class Q = T>
-            static
-            std::enable_if_t<std::is_void_v<typename GetBaseClass<Q>::value>, void>
-            setGettersAndMethods(CefRefPtr<CefV8Value>& retval, const T& value)
+            if(!WireCodec<T>::write(writer, value))
             {
-                for(auto& kv : Class<T>::getters)
-                {
-                    retval->SetValue(kv.first, V8_ACCESS_CONTROL_DEFAULT, V8_PROPERTY_ATTRIBUTE_NONE);
-                }
-
-                for(auto& kv : Class<T>::methods)
-                {
-                    retval->SetValue(kv.first, V8_ACCESS_CONTROL_DEFAULT, V8_PROPERTY_ATTRIBUTE_NONE);
-                }
+                return nullptr;
             }
 
-            template<class Q = T>
-            static
-            std::enable_if_t<!std::is_void_v<typename GetBaseClass<Q>::value>, void>
-            setGettersAndMethods(CefRefPtr<CefV8Value>& retval, const T& value)
-            {
-                for(auto& kv : Class<T>::getters)
-                {
-                    retval->SetValue(kv.first, V8_ACCESS_CONTROL_DEFAULT, V8_PROPERTY_ATTRIBUTE_NONE);
-                }
+            return CefBinaryValue::Create(writer.getData(), writer.getSize());
+        }
 
-                for(auto& kv : Class<T>::methods)
-                {
-                    retval->SetValue(kv.first, V8_ACCESS_CONTROL_DEFAULT, V8_PROPERTY_ATTRIBUTE_NONE);
-                }
+        template<typename T>
+        bool deserialize(CefRefPtr<CefBinaryValue> binary, T & value)
+        {
+            ensureBindings();
 
-                using baseType = typename GetBaseClass<Q>::value;
+            std::vector<char> data(binary->GetSize());
+            binary->GetData(data.data(), data.size(), 0);
 
-                ValueCreator<baseType>::setGettersAndMethods(retval, value);
+            WireReader reader(data.data(), data.size());
+            auto stored = WireCodec<T>::read(reader);
+
+            if(!reader.isValid())
+            {
+                return false;
             }
-        };
-    #endif
 
-    void executeJavaScript(const char *str);
+            value = WireCodec<T>::get(stored);
+            return true;
+        }
 
-    template<typename T>
-    void addGlobalObject(const T & object, const char *name)
-    {
-        #ifdef CEF
-            std::string copied_name = name;
-            const T * copied_object = & object;
+        // CefListValue fallback: one entry per field, nested value objects and containers become nested lists.
+        template<typename T>
+        CefRefPtr<CefListValue> serializeToList(const T & value)
+        {
+            ensureBindings();
+
+            CefRefPtr<CefListValue> list = CefListValue::Create();
 
-            if(hasContext())
+            if(!ListCodec<T>::write(*list, 0, value))
             {
-                CefRefPtr<CefV8Value> new_value;
-                ValueCreator<T>::create(new_value, * copied_object);
-                getModuleObject()->SetValue(copied_name, new_value, V8_PROPERTY_ATTRIBUTE_NONE);
+                return nullptr;
             }
-            else
-            {
-                getRegisterers().push_back(
-                    [copied_name, copied_object](CefRefPtr<CefV8Value> & module_object)
-                    {
-                        CefRefPtr<CefV8Value> new_value;
 
-                        ValueCreator<T>::create(new_value, * copied_object);
+            return list->GetList(0)->Copy();
+        }
 
-                        module_object->SetValue(copied_name, new_value, V8_PROPERTY_ATTRIBUTE_NONE);
-                    }
-                    );
-            }
-        #else
-            emscripten::val::global( "Module" ).set( name, emscripten::val( object ) );
-        #endif
-    }
+        template<typename T>
+        bool deserializeFromList(CefRefPtr<CefListValue> list, T & value)
+        {
+            ensureBindings();
+
+            CefRefPtr<CefListValue> wrapper = CefListValue::Create();
+            wrapper->SetList(0, list->Copy());
+
+            return ListCodec<T>::read(*wrapper, 0, value);
+        }
+    #endif
 }
 
 #ifdef EMSCRIPTEN
-    #define EMBINDCEFV8_DECLARE_CLASS(Class, Base) \
+    #define EMBINDCEFV8_DECLARE_CLASS(Class, ...) \
         namespace emscripten {\
             namespace internal {\
                 template<>\
@@ -1002,7 +3967,7 @@ namespace embindcefv8
         template<>\
         struct GetBaseClass<Class>\
         {\
-            using value = Base;\
+            using value = std::tuple_element_t<0, std::tuple<__VA_ARGS__>>;\
         };\
         }
 
@@ -1014,21 +3979,68 @@ namespace embindcefv8
             emscripten::internal::_embind_register_integer(emscripten::internal::TypeID<Enum>::get(), #Enum, sizeof(int), std::numeric_limits<int>::min(), std::numeric_limits<int>::max());\
         }
 
+    namespace embindcefv8
+    {
+        // Length and pointer of UTF-8 bytes in the wasm heap, decoded in place by JavaScript.
+        struct StringWire
+        {
+            uint32_t
+                length;
+            const char
+                * data;
+        };
+
+        static_assert(offsetof(StringWire, data) == 4 && sizeof(const char *) == 4, "EMBINDCEFV8_IMPLEMENT_STRING reads a 32-bit pointer at wire + 4");
+
+        template<typename C, class Enable = void>
+        struct StringLength
+        {
+            static size_t get(const C &, const char * data)
+            {
+                return strlen(data);
+            }
+        };
+
+        template<typename C>
+        struct StringLength<C, std::void_t<decltype(std::declval<const C &>().size())>>
+        {
+            static size_t get(const C & value, const char *)
+            {
+                return value.size();
+            }
+        };
+
+        // A view into the storage of the last result of class C, which is kept alive here until the next one replaces it.
+        // JavaScript decodes the view in fromWireType, right after the call returns, so nothing is allocated or freed per result:
+        // the result is copy-assigned into the kept object (a reference count bump for shared strings, or a copy into the
+        // capacity it already has) and the wire block is reused.
+        template<typename C, typename Convert>
+        StringWire * keepStringResult(const C & value, Convert convert)
+        {
+            static thread_local std::optional<C>
+                kept;
+            static thread_local StringWire
+                wire;
+
+            kept = value;
+
+            const char * data = convert(*kept);
+
+            wire.length = uint32_t(StringLength<C>::get(*kept, data));
+            wire.data = data;
+
+            return &wire;
+        }
+    }
+
     #define EMBINDCEFV8_DECLARE_STRING(Class, convert) \
         namespace emscripten {\
             namespace internal {\
                 template<>\
                 struct BindingType<Class> {\
-                    typedef struct {\
-                        size_t length;\
-                        char data[1];\
-                    } * WireType;\
+                    typedef embindcefv8::StringWire * WireType;\
                     static WireType toWireType(const Class& v) {\
-                        auto length = strlen(v.convert());\
-                        WireType wt = (WireType)malloc(sizeof(size_t) + length);\
-                        wt->length = length;\
-                        memcpy(wt->data, v.convert(), length);\
-                        return wt;\
+                        return embindcefv8::keepStringResult(v, [](const Class & kept) { return kept.convert(); });\
                     }\
                     static Class fromWireType(WireType v) {\
                         return Class(v->data, v->length);\
@@ -1039,16 +4051,41 @@ namespace embindcefv8
 
     #define EMBINDCEFV8_IMPLEMENT_STRING(Class) \
         EMSCRIPTEN_BINDINGS(Class) {\
-            emscripten::internal::_embind_register_std_string(emscripten::internal::TypeID<Class>::get(), #Class);\
+            EM_ASM_ARGS({\
+                var decoder = typeof TextDecoder !== 'undefined' ? new TextDecoder('utf8') : null;\
+                registerType($0, {\
+                    name: UTF8ToString($1),\
+                    fromWireType: function(wire) {\
+                        var length = HEAPU32[wire >> 2], data = HEAPU32[(wire + 4) >> 2];\
+                        return decoder && length > 16 ? decoder.decode(HEAPU8.subarray(data, data + length)) : UTF8ArrayToString(HEAPU8, data, length);\
+                    },\
+                    toWireType: function(destructors, value) {\
+                        var length = lengthBytesUTF8(value), wire = _malloc(8 + length + 1);\
+                        HEAPU32[wire >> 2] = length;\
+                        HEAPU32[(wire + 4) >> 2] = wire + 8;\
+                        stringToUTF8(value, wire + 8, length + 1);\
+                        if (destructors !== null) destructors.push(_free, wire);\
+                        return wire;\
+                    },\
+                    argPackAdvance: 8,\
+                    readValueFromPointer: simpleReadValueFromPointer,\
+                    destructorFunction: function(wire) { _free(wire); }\
+                });\
+            }, emscripten::internal::TypeID<Class>::get(), #Class);\
         }
 #else
-    #define EMBINDCEFV8_DECLARE_CLASS(Class, Base) \
+    #define EMBINDCEFV8_DECLARE_CLASS(Class, ...) \
         namespace embindcefv8\
         {\
         template<>\
         struct GetBaseClass<Class>\
         {\
-            using value = Base;\
+            using value = std::tuple_element_t<0, std::tuple<__VA_ARGS__>>;\
+        };\
+        template<>\
+        struct GetBaseClasses<Class>\
+        {\
+            using value = typename BaseClassList<__VA_ARGS__>::value;\
         };\
         }
 
@@ -1069,7 +4106,7 @@ namespace embindcefv8
         {\
             static void create(CefRefPtr<CefV8Value>& retval, const Enum value)\
             {\
-                retval = CefV8Value::CreateInt((int)value);\
+                retval = createInt((int)value);\
             }\
         };\
         template<> struct ValueConverter<Enum>\
@@ -1079,6 +4116,11 @@ namespace embindcefv8
                 return (Enum)v.GetIntValue();\
             }\
         };\
+        template<> struct WireCodec<Enum> : WirePrimitiveCodec<Enum>\
+        {\
+            static bool write(WireWriter & writer, const Enum value) { writer.writeInt((int)value); return true; }\
+            static Enum read(WireReader & reader) { return (Enum)reader.readInt(); }\
+        };\
         }
 
     #define EMBINDCEFV8_DECLARE_STRING(Class, convert)\
@@ -1088,23 +4130,27 @@ namespace embindcefv8
         {\
             static void create(CefRefPtr<CefV8Value>& retval, const Class value)\
             {\
-                retval = CefV8Value::CreateString(value . convert ());\
+                retval = CefV8Value::CreateString(toCefString(value . convert ()));\
             }\
         };\
         template<> struct ValueConverter<Class>\
         {\
             static Class get(CefV8Value & v)\
             {\
-                return v.GetStringValue().ToString().c_str();\
+                return toUtf8(v.GetStringValue()).c_str();\
             }\
         };\
         template<> struct ValueConverter<const Class &>\
         {\
             static Class get(CefV8Value & v)\
             {\
-                return v.GetStringValue().ToString().c_str();\
+                return toUtf8(v.GetStringValue()).c_str();\
             }\
         };\
+        template<> struct IsStringClass<Class>\
+        {\
+            static constexpr bool value = true;\
+        };\
         }
 
     #define EMBINDCEFV8_IMPLEMENT_STRING(Class)
@@ -13,7 +13,9 @@ CefRefPtr<Handler>
 CefRefPtr<CefBrowser>
     browser;
 bool
-    mustProcess(true);
+    mustProcess(true),
+    autoStop(true),
+    useExtension(false);
 std::vector<std::string>
     filesToExecute;
 
@@ -33,7 +35,7 @@ public:
 
     virtual bool Execute(const CefString& name, CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception) OVERRIDE
     {
-        mustProcess = false;
+        CefV8Context::GetCurrentContext()->GetBrowser()->SendProcessMessage(PID_BROWSER, CefProcessMessage::Create("stop"));
         return true;
     }
 
@@ -97,6 +99,11 @@ void App::OnContextCreated(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> fr
     embindcefv8::onContextCreated(& * context);
 }
 
+void App::OnContextReleased(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, CefRefPtr<CefV8Context> context)
+{
+    embindcefv8::onContextReleased(& * context);
+}
+
 void App::OnContextInitialized()
 {
     CefWindowInfo window_info;
@@ -116,12 +123,38 @@ void App::OnContextInitialized()
         content += "</script>";
     }
 
-    content += "<script>stop();</script>";
+    if(autoStop)
+    {
+        content += "<script>stop();</script>";
+    }
 
     browser->GetMainFrame()->LoadString(content, "dummy");
     embindcefv8::setBrowser(browser);
 }
 
+void App::OnWebKitInitialized()
+{
+    if(useExtension)
+    {
+        embindcefv8::registerExtension();
+    }
+}
+
+void App::OnRenderProcessThreadCreated(CefRefPtr<CefListValue> extra_info)
+{
+    embindcefv8::onRenderProcessThreadCreated(extra_info);
+}
+
+void App::OnRenderThreadCreated(CefRefPtr<CefListValue> extra_info)
+{
+    embindcefv8::onRenderThreadCreated(extra_info);
+}
+
+bool App::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser, CefProcessId source_process, CefRefPtr<CefProcessMessage> message)
+{
+    return embindcefv8::onProcessMessageReceived(browser, source_process, message);
+}
+
 void App::OnRegisterCustomSchemes(CefRefPtr<CefSchemeRegistrar> registrar)
 {
 }
@@ -142,7 +175,18 @@ bool Handler::OnConsoleMessage(CefRefPtr<CefBrowser> browser, const CefString& m
     return true;
 }
 
-void initCef(int argc, char *argv[])
+bool Handler::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser, CefProcessId source_process, CefRefPtr<CefProcessMessage> message)
+{
+    if(message->GetName() == "stop")
+    {
+        mustProcess = false;
+        return true;
+    }
+
+    return embindcefv8::onProcessMessageReceived(browser, source_process, message);
+}
+
+void initCef(int argc, char *argv[], const bool multi_process, const bool extension)
 {
     #ifdef _LINUX
         CefMainArgs args(argc, argv);
@@ -152,6 +196,8 @@ void initCef(int argc, char *argv[])
 
     CefRefPtr<App> app(new App);
 
+    useExtension = extension;
+
     int exit_code = CefExecuteProcess(args, app.get(), nullptr);
 
     if (exit_code >= 0)
@@ -161,10 +207,11 @@ void initCef(int argc, char *argv[])
     }
 
     handler = new Handler();
+    autoStop = !multi_process;
 
     CefSettings settings;
     memset(&settings, 0, sizeof(CefSettings));
-    settings.single_process = true;
+    settings.single_process = !multi_process;
     settings.no_sandbox = true;
     settings.multi_threaded_message_loop = false;
     settings.log_severity = LOGSEVERITY_DISABLE;
@@ -1,4 +1,6 @@
 #include "embindcefv8.h"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include "cef.h"
 
@@ -92,11 +94,41 @@ struct AStructContainer
         return a * b * c;
     }
 
+    int getDoubled() const
+    {
+        return aInt * 2;
+    }
+
+    void setDoubled(const int v)
+    {
+        aInt = v / 2;
+    }
+
+    int describe(const int a)
+    {
+        return a;
+    }
+
+    int describe(const int a, const int b)
+    {
+        return a + b;
+    }
+
+    std::string describe(const std::string text)
+    {
+        return text + "!";
+    }
+
     AStruct constructAStruct(const int v)
     {
         return AStruct(v);
     }
 
+    int readAStruct(const AStruct & value)
+    {
+        return value.intMember + int(value.floatMember);
+    }
+
     static int staticFunction()
     {
         return 32;
@@ -127,6 +159,27 @@ struct AStructContainer
         return a + b + c + d + e;
     }
 
+    static int countSpaces(std::string_view text)
+    {
+        return int(std::count(text.begin(), text.end(), ' '));
+    }
+
+#ifdef CEF
+    static bool setValidation(const bool enabled)
+    {
+        embindcefv8::setArgumentValidation(enabled);
+        return enabled;
+    }
+#endif
+
+    static int scriptFunction(int a, int b)
+    {
+        static embindcefv8::JavaScriptFunction
+            multiply("function(a, b) { return a * b; }");
+
+        return multiply.call<int>(a, b);
+    }
+
     AStruct
         aMember;
     int
@@ -144,8 +197,89 @@ public:
     }
 };
 
+struct AShape
+{
+    virtual ~AShape() = default;
+
+    virtual int sides() const
+    {
+        return 0;
+    }
+
+    static AShape * createSquare();
+};
+
+struct ASquare : public AShape
+{
+    int sides() const override
+    {
+        return 4;
+    }
+
+    int area() const
+    {
+        return 16;
+    }
+};
+
+AShape * AShape::createSquare()
+{
+    static ASquare
+        square;
+
+    return &square;
+}
+
+struct ACounted
+{
+    int
+        count = 3;
+};
+
+struct ANamed
+{
+    int twiceCode() const
+    {
+        return code * 2;
+    }
+
+    static int readCode(const ANamed & named)
+    {
+        return named.code;
+    }
+
+    int
+        code = 5;
+};
+
+struct AMixed : public ACounted, public ANamed
+{
+};
+
+struct ADescribedClass
+{
+    int twice(const int a) const
+    {
+        return a * 2;
+    }
+
+    static int sum(int a, int b)
+    {
+        return a + b;
+    }
+
+    int
+        aInt = 3;
+};
+
+EMBINDCEFV8_DECLARE_CLASS(ADescribedClass, void)
 EMBINDCEFV8_DECLARE_CLASS(AStructContainer, void)
 EMBINDCEFV8_DECLARE_CLASS(ADerivedClass, AStructContainer)
+EMBINDCEFV8_DECLARE_CLASS(AShape, void)
+EMBINDCEFV8_DECLARE_CLASS(ASquare, AShape)
+EMBINDCEFV8_DECLARE_CLASS(ACounted, void)
+EMBINDCEFV8_DECLARE_CLASS(ANamed, void)
+EMBINDCEFV8_DECLARE_CLASS(AMixed, ACounted, ANamed)
 EMBINDCEFV8_DECLARE_VALUE_OBJECT(AStruct)
 
 EMBINDCEFV8_BINDINGS(test)
@@ -163,6 +297,9 @@ EMBINDCEFV8_BINDINGS(test)
         .constructor<int>()
         .property("aMember", &AStructContainer::aMember)
         .property("aInt", &AStructContainer::aInt)
+        .property("doubled", &AStructContainer::getDoubled, &AStructContainer::setDoubled)
+        .constant_property("initialInt", &AStructContainer::aInt)
+        .view_property("aMemberView", &AStructContainer::aMember)
         .method("aMethod", &AStructContainer::aMethod)
         .method("aMethod1", &AStructContainer::aMethod1)
         .method("aMethod2", &AStructContainer::aMethod2)
@@ -172,32 +309,234 @@ EMBINDCEFV8_BINDINGS(test)
         .method("resultMethod1", &AStructContainer::resultMethod1)
         .method("resultMethod2", &AStructContainer::resultMethod2)
         .method("resultMethod3", &AStructContainer::resultMethod3)
+        .method("describe", static_cast<int (AStructContainer::*)(int)>(&AStructContainer::describe))
+        .method("describe", static_cast<int (AStructContainer::*)(int, int)>(&AStructContainer::describe))
+    #ifdef CEF
+        .method("describe", static_cast<std::string (AStructContainer::*)(std::string)>(&AStructContainer::describe))
+    #endif
         .method("constructAStruct", &AStructContainer::constructAStruct)
+        .method("readAStruct", &AStructContainer::readAStruct)
         .static_function("staticFunction", &AStructContainer::staticFunction)
         .static_function("staticFunction1", &AStructContainer::staticFunction1)
+        .static_function("map", &AStructContainer::staticFunction1)
         .static_function("staticFunction2", &AStructContainer::staticFunction2)
         .static_function("staticFunction3", &AStructContainer::staticFunction3)
         .static_function("staticFunction4", &AStructContainer::staticFunction4)
         .static_function("staticFunction5", &AStructContainer::staticFunction5)
+        .static_function("scriptFunction", &AStructContainer::scriptFunction)
+    #ifdef CEF
+        .static_function("countSpaces", &AStructContainer::countSpaces)
+        .static_function("setValidation", &AStructContainer::setValidation)
+    #endif
         ;
 
     embindcefv8::Class<ADerivedClass>("ADerivedClass")
         .constructor()
         .method("resultMethod", &ADerivedClass::resultMethod)
         ;
+
+    embindcefv8::Class<AShape>("AShape")
+        .polymorphic()
+        .method("sides", &AShape::sides)
+        .static_function("createSquare", &AShape::createSquare)
+        ;
+
+    embindcefv8::Class<ASquare>("ASquare")
+        .method("area", &ASquare::area)
+        ;
+
+    embindcefv8::Class<ACounted>("ACounted")
+        .property("count", &ACounted::count)
+        ;
+
+    embindcefv8::Class<ANamed>("ANamed")
+        .property("code", &ANamed::code)
+        .method("twiceCode", &ANamed::twiceCode)
+        .static_function("readCode", &ANamed::readCode)
+        ;
+
+    embindcefv8::Class<AMixed>("AMixed")
+        .constructor()
+        ;
+
+    static constexpr auto aDescribedClass = embindcefv8::class_<ADescribedClass>("ADescribedClass",
+        embindcefv8::ctor<>,
+        embindcefv8::prop<&ADescribedClass::aInt>("aInt"),
+        embindcefv8::method<&ADescribedClass::twice>("twice"),
+        embindcefv8::static_function<&ADescribedClass::sum>("sum")
+        );
+
+    aDescribedClass.install();
 }
 
+#ifdef CEF
+    AStructContainer
+        proxyContainer(64),
+        removedContainer(1);
+    AMixed
+        proxyMixed;
+
+    // Registration benchmark: the same member set bound through the builder and through descriptors.
+    template<int N>
+    struct BenchClass
+    {
+        int get() const
+        {
+            return value;
+        }
+
+        void set(const int v)
+        {
+            value = v;
+        }
+
+        static int make(int a)
+        {
+            return a + N;
+        }
+
+        int
+            value = N;
+    };
+
+    template<int ... Ns>
+    void registerWithBuilder(std::integer_sequence<int, Ns...>)
+    {
+        (embindcefv8::Class<BenchClass<Ns>>(("BuilderBench" + std::to_string(Ns)).c_str())
+            .constructor()
+            .property("value", &BenchClass<Ns>::value)
+            .method("get", &BenchClass<Ns>::get)
+            .method("set", &BenchClass<Ns>::set)
+            .static_function("make", &BenchClass<Ns>::make)
+            , ...);
+    }
+
+    template<int N>
+    void registerWithDescriptor()
+    {
+        static const std::string name = "DescriptorBench" + std::to_string(N);
+        const auto descriptor = embindcefv8::class_<BenchClass<N>>(name.c_str(),
+            embindcefv8::ctor<>,
+            embindcefv8::prop<&BenchClass<N>::value>("value"),
+            embindcefv8::method<&BenchClass<N>::get>("get"),
+            embindcefv8::method<&BenchClass<N>::set>("set"),
+            embindcefv8::static_function<&BenchClass<N>::make>("make")
+            );
+
+        descriptor.install();
+    }
+
+    template<int ... Ns>
+    void registerWithDescriptors(std::integer_sequence<int, Ns...>)
+    {
+        (registerWithDescriptor<Ns + 64>(), ...);
+    }
+
+    void benchmarkRegistration()
+    {
+        using Clock = std::chrono::steady_clock;
+
+        auto start = Clock::now();
+        registerWithBuilder(std::make_integer_sequence<int, 64>{});
+        auto builder = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+        start = Clock::now();
+        registerWithDescriptors(std::make_integer_sequence<int, 64>{});
+        auto descriptors = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+        std::cout << "[bench] builder registration: " << builder << " us for 64 classes" << std::endl;
+        std::cout << "[bench] descriptor registration: " << descriptors << " us for 64 classes" << std::endl;
+    }
+
+    // String marshalling benchmark: library transcoding against CefString's own conversion.
+    void benchmarkStrings()
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const std::pair<const char *, std::string> samples[] = {
+            { "ASCII", "The quick brown fox jumps over the lazy dog. " },
+            { "Latin-1", "Voil\xc3\xa0 une cr\xc3\xa8me br\xc3\xbbl\xc3\xa9" "e tr\xc3\xa8s \xc3\xa9l\xc3\xa9gante. " },
+            { "CJK", "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0\xe3\x80\x82\xe4\xb8\xad\xe6\x96\x87\xe5\xad\x97\xe7\xac\xa6\xe3\x80\x82" }
+        };
+        const int count = 20000;
+        // Conversion results are summed into the sink so the loops cannot be dropped.
+        static volatile size_t sink;
+
+        for(auto & sample : samples)
+        {
+            std::string text;
+            size_t total = 0;
+
+            while(text.size() < 4096)
+            {
+                text += sample.second;
+            }
+
+            const CefString wide(text);
+
+            auto start = Clock::now();
+            for(int i = 0; i < count; ++i) total += embindcefv8::toCefString(text).length();
+            auto library_in = std::chrono::duration<double>(Clock::now() - start).count();
+
+            start = Clock::now();
+            for(int i = 0; i < count; ++i) total += CefString(text).length();
+            auto cef_in = std::chrono::duration<double>(Clock::now() - start).count();
+
+            start = Clock::now();
+            for(int i = 0; i < count; ++i) total += embindcefv8::toUtf8(wide).size();
+            auto library_out = std::chrono::duration<double>(Clock::now() - start).count();
+
+            start = Clock::now();
+            for(int i = 0; i < count; ++i) total += wide.ToString().size();
+            auto cef_out = std::chrono::duration<double>(Clock::now() - start).count();
+
+            const double megabytes = double(text.size()) * count / 1e6;
+            sink = sink + total;
+
+            std::cout << "[bench] " << sample.first << " toCefString: " << megabytes / library_in << " MB/s for " << text.size() << " bytes" << std::endl;
+            std::cout << "[bench] " << sample.first << " CefString from UTF-8: " << megabytes / cef_in << " MB/s for " << text.size() << " bytes" << std::endl;
+            std::cout << "[bench] " << sample.first << " toUtf8: " << megabytes / library_out << " MB/s for " << text.size() << " bytes" << std::endl;
+            std::cout << "[bench] " << sample.first << " CefString::ToString: " << megabytes / cef_out << " MB/s for " << text.size() << " bytes" << std::endl;
+        }
+    }
+#endif
+
 int main(int argc, char* argv[])
 {
     #ifdef EMSCRIPTEN
         EM_ASM( global.Module = Module; var test = require('./kludjs.js'); global.test = test; require('./main.js'); );
     #else
+        const bool proxy = argc > 1 && std::string(argv[1]) == "--proxy";
+        const bool extension = argc > 1 && std::string(argv[1]) == "--extension";
+
         executeFile("kludjs.js");
-        executeFile("main.js");
+        executeFile(proxy ? "proxy.js" : "main.js");
     #endif
 
     #ifdef CEF
-        initCef(argc, argv);
+        if(argc > 1 && std::string(argv[1]) == "--bench-registration")
+        {
+            benchmarkRegistration();
+            return 0;
+        }
+
+        if(argc > 1 && std::string(argv[1]) == "--bench-strings")
+        {
+            benchmarkStrings();
+            return 0;
+        }
+
+        embindcefv8::allowPlugin("testplugin");
+
+        if(proxy)
+        {
+            embindcefv8::addProxyObject(proxyContainer, "proxyContainer");
+            embindcefv8::addProxyObject(proxyMixed, "proxyMixed");
+            embindcefv8::addProxyObject(removedContainer, "removedContainer");
+            embindcefv8::removeProxyObject(removedContainer);
+        }
+
+        initCef(argc, argv, proxy, extension);
         processLoop();
         finalizeCef();
     #endif
@@ -24,6 +24,120 @@ test('Class - constructor0', function() {
     ok(o.aMember.stringMember == "A sample string", 'ValueObject property');
 });
 
+test('Class - writable properties', function() {
+    var o = new Module.AStructContainer();
+
+    o.aInt = 5;
+    ok(o.aInt === 5, 'Int property');
+    ok(o.resultMethod1(o.aInt) === 5, 'Read back from C++');
+
+    o.aMember = Module.AStruct(2);
+    ok(o.aMember.intMember == 2048, 'ValueObject property');
+});
+
+test('Class - non-ASCII strings', function() {
+    var o = new Module.AStructContainer();
+    var text = 'caf\u00e9 \u65e5\u672c\u8a9e \ud83d\ude00 ' + new Array(40).join('ascii ');
+
+    o.aMember = { floatMember: 1, intMember: 2, stringMember: text };
+    ok(o.aMember.stringMember === text, 'Round trip');
+});
+
+test('Class - getter/setter properties', function() {
+    var o = new Module.AStructContainer();
+
+    ok(o.doubled === 256, 'Getter');
+    o.doubled = 10;
+    ok(o.aInt === 5, 'Setter');
+});
+
+test('Class - constant properties', function() {
+    var o = new Module.AStructContainer(7);
+
+    ok(o.initialInt === 7, 'Constant property');
+    ok(o.initialInt === 7, 'Second read');
+});
+
+test('Class - ValueObject views', function() {
+    var o = new Module.AStructContainer();
+
+    ok(o.aMemberView.intMember == 1024, 'Read through view');
+
+    // Emscripten exposes view properties as copies.
+    if (Module.load) {
+        o.aMemberView.intMember = 3;
+        ok(o.aMember.intMember == 3, 'Write through view');
+    }
+});
+
+test('Class - bulk property access', function() {
+    // Emscripten has no bulk accessors.
+    if (!Module.load) {
+        ok(true, 'Skipped');
+        return;
+    }
+
+    var o = new Module.AStructContainer();
+    var r = o.__read(['aInt', 'doubled']);
+
+    ok(r[0] === 128 && r[1] === 256, 'Read');
+    ok(o.__snapshot().aInt === 128, 'Snapshot');
+    ok(o.__assign({ aInt: 4 }) && o.aInt === 4, 'Assign');
+    ok(!o.__assign({ initialInt: 1 }), 'Read-only property');
+});
+
+test('Class - calls over arrays', function() {
+    ok(Module.AStructContainer.map(7) === Module.AStructContainer.staticFunction1(7), 'User function named map');
+
+    // Emscripten has no vectorized calls.
+    if (!Module.load) {
+        return;
+    }
+
+    var objects = [new Module.AStructContainer(1), new Module.AStructContainer(2), new Module.AStructContainer(3)];
+    var r = Module.AStructContainer.__map('resultMethod2', objects, 2, 5);
+
+    ok(r.length === 3 && r[2] === 10, 'Map');
+    Module.AStructContainer.__invokeAll('modifyMembers', objects);
+    ok(objects[1].aMember.intMember == 2048, 'Invoke all');
+
+    var error = function(call) {
+        try {
+            call();
+        } catch (e) {
+            return e;
+        }
+    };
+
+    ok(error(function() { Module.AStructContainer.__map('resultMethod2', objects); }) instanceof TypeError, 'Missing arguments');
+    ok(error(function() { Module.AStructContainer.__map('missingMethod', objects); }) instanceof TypeError, 'Unknown method');
+    ok(error(function() { Module.AStructContainer.__invokeAll('modifyMembers', [objects[0], {}]); }) instanceof TypeError, 'Unwrapped element');
+});
+
+test('Class - cached primitive results', function() {
+    var o = new Module.AStructContainer();
+
+    ok(o.resultMethod2(3, 4) === 12 && o.resultMethod2(3, 4) === 12, 'Cached integer');
+    ok(o.resultMethod2(-200, 1) === -200, 'Integer below the cache');
+    ok(o.resultMethod2(1000, 1000) === 1000000, 'Integer above the cache');
+});
+
+test('Module - command buffer', function() {
+    // Emscripten has no command buffers.
+    if (!Module.__flush) {
+        ok(true, 'Skipped');
+        return;
+    }
+
+    var o = new Module.AStructContainer();
+    var method = Module.__binding('AStructContainer', 'resultMethod2');
+    var sum = Module.__binding('AStructContainer', 'staticFunction2');
+    var r = Module.__flush([method, o, 2, 3, 4, sum, null, 2, 5, 6]);
+
+    ok(r.length === 2, 'Result count');
+    ok(r[0] === 12 && r[1] === 11, 'Results');
+});
+
 test('Class - void methods', function() {
     var o = new Module.AStructContainer();
 
@@ -60,6 +174,11 @@ test('Class - static function', function() {
     ok(Module.AStructContainer.staticFunction5(1, 1, 1, 1, 1) === 5, '5 arguments');
 });
 
+test('JavaScriptFunction - compiled call', function() {
+    ok(Module.AStructContainer.scriptFunction(6, 7) === 42, 'First call');
+    ok(Module.AStructContainer.scriptFunction(2, 3) === 6, 'Cached function');
+});
+
 test('Class - ValueObject result methods', function() {
     var o = new Module.AStructContainer();
     var r;
@@ -70,6 +189,12 @@ test('Class - ValueObject result methods', function() {
     ok(r.stringMember == "A sample string", 'String property');
 });
 
+test('Class - ValueObject argument methods', function() {
+    var o = new Module.AStructContainer();
+
+    ok(o.readAStruct(Module.AStruct(2)) === 2080, 'A struct argument call');
+});
+
 test('Class - inherited methods', function() {
     var o = new Module.ADerivedClass();
 
@@ -78,3 +203,181 @@ test('Class - inherited methods', function() {
     ok(o.resultMethod2(4, 2) === 8, 'Inherited method');
     ok(o.resultMethod3(4, 2, 3) === 24, 'Inherited method');
 });
+
+test('Class - string view arguments', function() {
+    // Emscripten has no std::string_view binding.
+    if (!Module.load) {
+        ok(true, 'Skipped');
+        return;
+    }
+
+    ok(Module.AStructContainer.countSpaces('a b c') === 2, 'Short string');
+    ok(Module.AStructContainer.countSpaces(new Array(2001).join('x ')) === 2000, 'Arena-backed string');
+});
+
+test('Class - overloaded methods', function() {
+    var o = new Module.AStructContainer();
+
+    ok(o.describe(2) === 2, 'One argument');
+    ok(o.describe(2, 3) === 5, 'Two arguments');
+
+    // Emscripten dispatches on arity only.
+    if (Module.load) {
+        ok(o.describe('text') === 'text!', 'String argument');
+    }
+});
+
+test('Class - argument validation', function() {
+    // Emscripten reports its own binding errors.
+    if (!Module.load) {
+        ok(true, 'Skipped');
+        return;
+    }
+
+    var o = new Module.AStructContainer();
+    var error = function(call) {
+        try {
+            call();
+        } catch (e) {
+            return e;
+        }
+    };
+
+    ok(error(function() { o.resultMethod2(1); }) instanceof TypeError, 'Missing argument');
+    ok(error(function() { o.resultMethod2('a', 2); }) instanceof TypeError, 'Wrong type');
+    ok(error(function() { o.describe(2, 'a'); }) instanceof TypeError, 'Wrong type for the only overload of that arity');
+    ok(o.resultMethod2(3, 4, 5) === 12, 'Extra argument ignored');
+    ok(error(function() { Module.AStruct(1, 2, 3); }) instanceof TypeError, 'No value object constructor overload');
+    ok(error(function() { new Module.ACounted(); }) instanceof TypeError, 'No class constructor');
+
+    Module.AStructContainer.setValidation(false);
+    ok(typeof o.readAStruct(5) === 'number', 'Unchecked non-object value object argument');
+    Module.AStructContainer.setValidation(true);
+});
+
+test('Class - argument validation benchmark', function() {
+    if (!Module.load) {
+        ok(true, 'Skipped');
+        return;
+    }
+
+    var o = new Module.AStructContainer();
+    var count = 100000;
+    var time = function() {
+        var start = Date.now();
+
+        for (var i = 0; i < count; ++i) {
+            o.resultMethod2(i, 2);
+        }
+
+        return Math.max(Date.now() - start, 1);
+    };
+
+    Module.AStructContainer.setValidation(false);
+    var unchecked = time();
+    Module.AStructContainer.setValidation(true);
+    var checked = time();
+
+    console.log('[bench] validated calls: ' + Math.round(count * 1000 / checked) + ' calls/s, unchecked: ' + Math.round(count * 1000 / unchecked) + ' calls/s');
+    ok(true, 'Benchmark');
+});
+
+test('Class - polymorphic results', function() {
+    var shape = Module.AShape.createSquare();
+
+    ok(shape.sides() === 4, 'Virtual method');
+    ok(shape.area() === 16, 'Most-derived method');
+});
+
+test('Class - multiple inheritance', function() {
+    var o = new Module.AMixed();
+
+    ok(o.count === 3, 'Primary base property');
+
+    // Emscripten has no secondary bases.
+    if (!Module.load) {
+        ok(true, 'Skipped');
+        return;
+    }
+
+    ok(o.code === 5, 'Secondary base property');
+    ok(o.twiceCode() === 10, 'Secondary base method');
+    ok(Module.ANamed.readCode(o) === 5, 'Secondary base argument');
+
+    var error = function(call) {
+        try {
+            call();
+        } catch (e) {
+            return e;
+        }
+    };
+    var other = new Module.AStructContainer();
+
+    Module.AStructContainer.setValidation(false);
+    ok(error(function() { Module.ANamed.readCode(other); }) instanceof TypeError, 'Unrelated argument');
+    ok(error(function() { Module.ANamed.readCode({}); }) instanceof TypeError, 'Plain object argument');
+    ok(error(function() { o.twiceCode.call(other); }) instanceof TypeError, 'Unrelated object');
+    Module.AStructContainer.setValidation(true);
+});
+
+test('Class - compile-time descriptor', function() {
+    var o = new Module.ADescribedClass();
+
+    ok(o.aInt === 3, 'Property');
+    ok(o.twice(21) === 42, 'Method');
+    ok(Module.ADescribedClass.sum(2, 3) === 5, 'Static function');
+
+    if (Module.load) {
+        var error = function(call) {
+            try {
+                call();
+            } catch (e) {
+                return e;
+            }
+        };
+
+        ok(error(function() { o.twice(); }) instanceof TypeError, 'Method argument count');
+        ok(o.__read(['aInt'])[0] === 3, 'Indexed builtin method');
+        ok(o.missing === undefined, 'Missing member');
+        o.aInt = 4;
+        ok(o.aInt === 4, 'Indexed property write');
+        ok(error(function() { Module.ADescribedClass.sum('a', 3); }) instanceof TypeError, 'Static function argument type');
+    }
+});
+
+test('Module - plugin', function() {
+    if (!Module.load) {
+        ok(true, 'No plugin support');
+        return;
+    }
+
+    var refused = function(name) {
+        try {
+            Module.load(name);
+        } catch (e) {
+            return true;
+        }
+
+        return false;
+    };
+
+    ok(refused('../testplugin') && refused('otherplugin'), 'Names outside the allowlist');
+    ok(Module.load('testplugin'), 'Load');
+
+    var o = new Module.APluginClass();
+    var value = o.value;
+
+    ok(value.call(o) === 7, 'Plugin method');
+    ok(Module.unload('testplugin'), 'Unload');
+    ok(typeof Module.APluginClass === 'undefined', 'Class removed');
+
+    var thrown = false;
+
+    try {
+        value.call(o);
+    } catch (e) {
+        thrown = true;
+    }
+
+    ok(thrown, 'Wrapper invalidated');
+});
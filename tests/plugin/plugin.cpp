@@ -0,0 +1,21 @@
+#include "embindcefv8.h"
+
+#ifdef CEF
+
+struct APluginClass
+{
+    int value() const
+    {
+        return 7;
+    }
+};
+
+EMBINDCEFV8_PLUGIN
+{
+    embindcefv8::Class<APluginClass>("APluginClass")
+        .constructor()
+        .method("value", &APluginClass::value)
+        ;
+}
+
+#endif
@@ -0,0 +1,153 @@
+
+function fail(done) {
+    return function(e) {
+        ok(false, e.message);
+        done();
+    };
+}
+
+test('Proxy - method call', function(done) {
+    Module.proxyContainer.resultMethod2(4, 2).then(function(r) {
+        ok(r === 8, 'Method result');
+        done();
+    }, fail(done));
+}, true);
+
+test('Proxy - static function', function(done) {
+    Module.remote.AStructContainer.staticFunction3(4, 4, 4).then(function(r) {
+        ok(r === 12, 'Static function result');
+        done();
+    }, fail(done));
+}, true);
+
+test('Proxy - batched calls', function(done) {
+    var o = Module.proxyContainer;
+
+    Promise.all([o.resultMethod(), o.resultMethod1(4), o.resultMethod3(4, 2, 3)]).then(function(r) {
+        ok(r[0] === 128, 'First call');
+        ok(r[1] === 4, 'Second call');
+        ok(r[2] === 24, 'Third call');
+        done();
+    }, fail(done));
+}, true);
+
+test('Proxy - ValueObject result', function(done) {
+    Module.proxyContainer.constructAStruct(2).then(function(r) {
+        ok(r.floatMember == 32, 'Float property');
+        ok(r.intMember == 2048, 'Int property');
+        ok(r.stringMember == "A sample string", 'String property');
+        done();
+    }, fail(done));
+}, true);
+
+test('Proxy - ValueObject argument', function(done) {
+    var o = Module.proxyContainer;
+
+    Promise.all([
+        o.readAStruct({ floatMember: 32, intMember: 2048, stringMember: "" }),
+        o.readAStruct({ intMember: 2048, floatMember: 32 })
+    ]).then(function(r) {
+        ok(r[0] === 2080, 'A struct argument call');
+        ok(r[1] === 2080, 'Fields in any order, missing ones left at their default');
+        done();
+    }, fail(done));
+}, true);
+
+test('Proxy - overloaded methods', function(done) {
+    var o = Module.proxyContainer;
+
+    Promise.all([o.describe(2), o.describe(2, 3), o.describe('text')]).then(function(r) {
+        ok(r[0] === 2, 'One argument');
+        ok(r[1] === 5, 'Two arguments');
+        ok(r[2] === 'text!', 'String argument');
+        done();
+    }, fail(done));
+}, true);
+
+test('Proxy - invalid call', function(done) {
+    Module.proxyContainer.resultMethod1().then(function(r) {
+        ok(false, 'Call with missing argument resolved');
+        done();
+    }, function(e) {
+        ok(e instanceof Error, 'Call with missing argument rejected');
+        done();
+    });
+}, true);
+
+test('Proxy - nesting limit', function(done) {
+    var nested = function(depth) {
+        var value = [];
+
+        for (var i = 0; i < depth; ++i) {
+            value = [value];
+        }
+
+        return value;
+    };
+    var o = Module.proxyContainer;
+
+    Promise.all([
+        o.resultMethod1(4, nested(8)),
+        o.resultMethod1(4, nested(1000)).then(function() { return null; }, function(e) { return e; })
+    ]).then(function(r) {
+        ok(r[0] === 4, 'Extra nested argument skipped');
+        ok(r[1] instanceof Error, 'Over-deep argument rejected');
+        done();
+    }, fail(done));
+}, true);
+
+test('Proxy - handle classes', function(done) {
+    var rejected = function(promise) {
+        return promise.then(function() { return null; }, function(e) { return e; });
+    };
+
+    Promise.all([
+        Module.remote.ANamed.readCode(Module.proxyMixed),
+        rejected(Module.remote.ANamed.readCode(Module.proxyContainer))
+    ]).then(function(r) {
+        ok(r[0] === 5, 'Secondary base handle');
+        ok(r[1] instanceof Error, 'Unrelated handle rejected');
+        ok(Module.removedContainer === undefined, 'Removed object not exposed');
+        done();
+    }, fail(done));
+}, true);
+
+test('Proxy - round trip benchmark', function(done) {
+    var o = Module.proxyContainer;
+    var count = 1000;
+    var start = Date.now();
+
+    var sequential = function(remaining) {
+        if (remaining == 0) {
+            var latency = (Date.now() - start) / count;
+            console.log('[bench] proxy latency: ' + latency.toFixed(3) + ' ms per round trip');
+
+            var calls = [];
+            start = Date.now();
+
+            for (var i = 0; i < count * 10; ++i) {
+                calls.push(o.resultMethod1(i));
+            }
+
+            Promise.all(calls).then(function(r) {
+                var elapsed = Math.max(Date.now() - start, 1);
+                console.log('[bench] proxy throughput: ' + Math.round(r.length * 1000 / elapsed) + ' calls/s');
+                ok(r[r.length - 1] === count * 10 - 1, 'Batched results');
+                done();
+            }, fail(done));
+
+            return;
+        }
+
+        o.resultMethod1(remaining).then(function() {
+            sequential(remaining - 1);
+        }, fail(done));
+    };
+
+    sequential(count);
+}, true);
+
+test('Proxy - done', function(done) {
+    done();
+    stop();
+}, true);